@@ -0,0 +1,18 @@
+/*
+ * HostClock.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "HostClock.h"
+#include <time.h>
+
+
+double HostClock_Ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
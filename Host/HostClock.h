@@ -0,0 +1,21 @@
+/*
+ * HostClock.h
+ *
+ *  Monotonic wall clock for timing the host benchmarks themselves
+ *  (not the simulated bus time, see SimI2C_NowNs).
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#ifndef HOST_HOSTCLOCK_H_
+#define HOST_HOSTCLOCK_H_
+
+
+/**
+ * @brief Host monotonic clock in nanoseconds
+ */
+double HostClock_Ns(void);
+
+
+#endif /* HOST_HOSTCLOCK_H_ */
@@ -0,0 +1,72 @@
+/*
+ * SimFlash.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#include "SimFlash.h"
+#include <string.h>
+
+
+static HAL_StatusTypeDef SimFlash_Read(void *ctx, uint32_t addr, void *buf, uint32_t len) {
+    SimFlash_t *flash = (SimFlash_t *)ctx;
+
+    if (addr + len > flash->size)
+    	return HAL_ERROR;
+
+    memcpy(buf, &flash->mem[addr], len);
+    flash->reads++;
+    flash->read_bytes += len;
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef SimFlash_Program(void *ctx, uint32_t addr, const void *buf, uint32_t len) {
+    SimFlash_t *flash = (SimFlash_t *)ctx;
+    const uint8_t *src = (const uint8_t *)buf;
+
+    if (addr + len > flash->size)
+    	return HAL_ERROR;
+
+    // NOR semantics: programming can only clear bits
+    for (uint32_t i = 0; i < len; i++)
+        flash->mem[addr + i] &= src[i];
+
+    flash->programs++;
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef SimFlash_ErasePage(void *ctx, uint32_t addr) {
+    SimFlash_t *flash = (SimFlash_t *)ctx;
+
+    if ((addr % flash->page_size) != 0 || addr + flash->page_size > flash->size)
+    	return HAL_ERROR;
+
+    memset(&flash->mem[addr], 0xFF, flash->page_size);
+    flash->erases++;
+    return HAL_OK;
+}
+
+
+void SimFlash_Init(SimFlash_t *flash, uint8_t *mem, uint32_t size, uint32_t page_size) {
+    memset(flash, 0, sizeof(*flash));
+    flash->mem = mem;
+    flash->size = size;
+    flash->page_size = page_size;
+    memset(mem, 0xFF, size);
+}
+
+void SimFlash_GetBackend(SimFlash_t *flash, SensorStore_Flash_t *backend) {
+    backend->read = SimFlash_Read;
+    backend->program = SimFlash_Program;
+    backend->erase_page = SimFlash_ErasePage;
+    backend->ctx = flash;
+    backend->page_size = flash->page_size;
+}
+
+void SimFlash_ResetCounters(SimFlash_t *flash) {
+    flash->reads = 0;
+    flash->read_bytes = 0;
+    flash->programs = 0;
+    flash->erases = 0;
+}
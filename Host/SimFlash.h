@@ -0,0 +1,51 @@
+/*
+ * SimFlash.h
+ *
+ *  RAM backed NOR flash model for host builds of SensorStore.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#ifndef HOST_SIMFLASH_H_
+#define HOST_SIMFLASH_H_
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "SensorStore.h"
+
+typedef struct {
+    uint8_t *mem;
+    uint32_t size;
+    uint32_t page_size;
+
+    // Access counters, used by the benchmarks
+    uint32_t reads;
+    uint32_t read_bytes;
+    uint32_t programs;
+    uint32_t erases;
+} SimFlash_t;
+
+
+/**
+ * @brief Attach a RAM buffer and erase it
+ * @param flash Simulated flash instance
+ * @param mem Backing memory, size bytes
+ * @param size Total size in bytes, multiple of page_size
+ * @param page_size Erase page size in bytes
+ */
+void SimFlash_Init(SimFlash_t *flash, uint8_t *mem, uint32_t size, uint32_t page_size);
+
+
+/**
+ * @brief Fill a SensorStore flash backend that targets this simulated flash
+ */
+void SimFlash_GetBackend(SimFlash_t *flash, SensorStore_Flash_t *backend);
+
+
+void SimFlash_ResetCounters(SimFlash_t *flash);
+
+
+#endif /* HOST_SIMFLASH_H_ */
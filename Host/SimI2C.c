@@ -0,0 +1,147 @@
+/*
+ * SimI2C.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#include "SimI2C.h"
+#include <string.h>
+
+I2C_HandleTypeDef hi2c1 = { { 100000u } };
+
+static SimI2C_Device_t devices[SIMI2C_MAX_DEVICES];
+static uint8_t device_count = 0;
+static SimI2C_Stats_t stats;
+static uint64_t now_ns = 0;
+
+
+static SimI2C_Device_t *SimI2C_Find(uint16_t addr) {
+    for (uint8_t i = 0; i < device_count; i++) {
+        if (devices[i].addr == addr)
+        	return &devices[i];
+    }
+    return NULL;
+}
+
+// Sensirion CRC-8 (0x31, init 0xFF) as computed by the sensor, independent of the driver under test
+static uint8_t SimI2C_SensirionCRC(const uint8_t *data, uint16_t count) {
+    uint8_t crc = 0xFF;
+
+    for (uint16_t i = 0; i < count; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+// START + address + data, 9 clocks per byte, plus STOP and bus free time
+static uint64_t SimI2C_WireNs(I2C_HandleTypeDef *hi2c, uint16_t size) {
+    uint64_t bit_ns = 1000000000ull / hi2c->Init.ClockSpeed;
+    return bit_ns * (9u * (1u + size) + 3u);
+}
+
+static HAL_StatusTypeDef SimI2C_Transfer(I2C_HandleTypeDef *hi2c, uint16_t addr, uint8_t *data, uint16_t size, bool read) {
+    SimI2C_Device_t *dev = SimI2C_Find(addr);
+    uint64_t ns;
+
+    stats.transactions++;
+
+    // A NACKed address still costs the address byte
+    if (dev == NULL) {
+        ns = SimI2C_WireNs(hi2c, 0);
+        stats.bus_ns += ns;
+        now_ns += ns;
+        return HAL_ERROR;
+    }
+
+    if (dev->max_scl_hz != 0 && hi2c->Init.ClockSpeed > dev->max_scl_hz)
+    	stats.violations++;
+
+    ns = SimI2C_WireNs(hi2c, size);
+    stats.bus_ns += ns;
+    now_ns += ns;
+
+    if (read) {
+        if (dev->on_read == NULL) {
+            memset(data, 0, size);
+            return HAL_OK;
+        }
+        return dev->on_read(dev->ctx, data, size);
+    }
+
+    return (dev->on_write == NULL) ? HAL_OK : dev->on_write(dev->ctx, data, size);
+}
+
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c) {
+    if (hi2c->Init.ClockSpeed == 0 || hi2c->Init.ClockSpeed > 1000000u)
+    	return HAL_ERROR;
+
+    stats.reinits++;
+    stats.reinit_ns += SIMI2C_REINIT_NS;
+    now_ns += SIMI2C_REINIT_NS;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    (void)Timeout;
+    return SimI2C_Transfer(hi2c, DevAddress, pData, Size, false);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout) {
+    (void)Timeout;
+    return SimI2C_Transfer(hi2c, DevAddress, pData, Size, true);
+}
+
+void HAL_Delay(uint32_t Delay) {
+    now_ns += (uint64_t)Delay * 1000000ull;
+}
+
+uint32_t HAL_GetTick(void) {
+    return (uint32_t)(now_ns / 1000000ull);
+}
+
+
+HAL_StatusTypeDef SimI2C_Attach(const SimI2C_Device_t *device) {
+    if (device_count == SIMI2C_MAX_DEVICES)
+    	return HAL_ERROR;
+
+    devices[device_count++] = *device;
+    return HAL_OK;
+}
+
+void SimI2C_Reset(uint32_t scl_hz) {
+    device_count = 0;
+    memset(&stats, 0, sizeof(stats));
+    now_ns = 0;
+    hi2c1.Init.ClockSpeed = scl_hz;
+}
+
+void SimI2C_GetStats(SimI2C_Stats_t *out) {
+    *out = stats;
+}
+
+uint64_t SimI2C_NowNs(void) {
+    return now_ns;
+}
+
+void SimI2C_AdvanceNs(uint64_t ns) {
+    now_ns += ns;
+}
+
+void SimI2C_EncodeSPS30Float(const float *v, uint8_t *frame) {
+    for (uint8_t i = 0; i < SIMI2C_SPS30_FLOAT_VALUES; i++) {
+        uint8_t *p = &frame[i * 6];
+        uint32_t u;
+
+        memcpy(&u, &v[i], sizeof(u));
+        p[0] = u >> 24;
+        p[1] = u >> 16;
+        p[2] = SimI2C_SensirionCRC(&p[0], 2);
+        p[3] = u >> 8;
+        p[4] = u;
+        p[5] = SimI2C_SensirionCRC(&p[3], 2);
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * SimI2C.h
+ *
+ *  Simulated I2C bus and HAL time base for host builds. Every transaction
+ *  advances a virtual clock by the time it would take on the wire at the
+ *  SCL rate currently programmed into the handle.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#ifndef HOST_SIMI2C_H_
+#define HOST_SIMI2C_H_
+
+#include "main.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef SIMI2C_MAX_DEVICES
+#define SIMI2C_MAX_DEVICES      8
+#endif
+
+#define SIMI2C_REINIT_NS        12000u  // Peripheral disable / configure / enable
+
+#define SIMI2C_SPS30_FLOAT_VALUES   10      // Values in an SPS30 float measurement frame
+
+typedef struct {
+    uint16_t addr;
+    uint32_t max_scl_hz;    // Transactions above this rate are counted as violations
+    HAL_StatusTypeDef (*on_write)(void *ctx, const uint8_t *data, uint16_t size);
+    HAL_StatusTypeDef (*on_read)(void *ctx, uint8_t *data, uint16_t size);
+    void *ctx;
+} SimI2C_Device_t;
+
+typedef struct {
+    uint64_t bus_ns;        // Time SCL was clocking
+    uint64_t reinit_ns;     // Time spent in HAL_I2C_Init
+    uint32_t transactions;
+    uint32_t reinits;
+    uint32_t violations;
+} SimI2C_Stats_t;
+
+
+/**
+ * @brief Attach a simulated device; callbacks may be NULL to ACK and return zeros
+ */
+HAL_StatusTypeDef SimI2C_Attach(const SimI2C_Device_t *device);
+
+
+/**
+ * @brief Detach all devices, clear statistics and rewind the virtual clock
+ */
+void SimI2C_Reset(uint32_t scl_hz);
+
+
+void SimI2C_GetStats(SimI2C_Stats_t *stats);
+
+
+uint64_t SimI2C_NowNs(void);
+
+
+void SimI2C_AdvanceNs(uint64_t ns);
+
+
+/**
+ * @brief Wire format of an SPS30 float measurement as the sensor sends it:
+ *        each value as two big-endian words, each followed by its CRC
+ * @param v SIMI2C_SPS30_FLOAT_VALUES values
+ * @param frame Output, SIMI2C_SPS30_FLOAT_VALUES * 6 bytes
+ */
+void SimI2C_EncodeSPS30Float(const float *v, uint8_t *frame);
+
+
+#endif /* HOST_SIMI2C_H_ */
@@ -0,0 +1,164 @@
+/*
+ * bench_capture.c
+ *
+ *  CPU per sample of raw burst capture (Capture.c) against eager decoding
+ *  through SPS30_ReadMeasuredValues / BH1750_CalcLux, on the simulated bus.
+ *
+ *  Build:
+ *    gcc -O2 -std=c11 -IHost -ILibraries Host/bench_capture.c Host/SimI2C.c Host/HostClock.c \
+ *        Libraries/Capture.c Libraries/I2CBus.c Libraries/BH1750.c Libraries/SPS30.c -o bench_capture
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SimI2C.h"
+#include "HostClock.h"
+#include "Capture.h"
+
+#define NUM_SAMPLES     20000   // Pairs of SPS30 frame + BH1750 count
+#define ARENA_SIZE      (NUM_SAMPLES * (2 * CAPTURE_ENTRY_HEADER_LEN + SPS30_MEASURED_FLOAT_LEN + 2))
+
+typedef struct {
+    uint32_t seq;
+} SimSensor_t;
+
+static uint8_t arena_buf[ARENA_SIZE];
+static SPS30_Measurement_Float_t eager_pm[NUM_SAMPLES];
+static float eager_lux[NUM_SAMPLES];
+static volatile float sink;
+
+// SPS30 float frame with a different value per sample and valid CRCs
+static HAL_StatusTypeDef sps30_read(void *ctx, uint8_t *data, uint16_t size) {
+    SimSensor_t *s = (SimSensor_t *)ctx;
+    float v[SIMI2C_SPS30_FLOAT_VALUES];
+    (void)size;
+
+    for (uint8_t i = 0; i < SIMI2C_SPS30_FLOAT_VALUES; i++)
+        v[i] = (float)(s->seq % 500) * 0.1f + (float)i;
+
+    SimI2C_EncodeSPS30Float(v, data);
+    s->seq++;
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef bh1750_read(void *ctx, uint8_t *data, uint16_t size) {
+    SimSensor_t *s = (SimSensor_t *)ctx;
+    (void)size;
+
+    data[0] = (s->seq >> 8) & 0xFF;
+    data[1] = s->seq & 0xFF;
+    s->seq++;
+    return HAL_OK;
+}
+
+static void setup(SimSensor_t *sps, SimSensor_t *bh) {
+    SimI2C_Device_t d_bh = { BH1750_ADDR, BH1750_MAX_SCL_HZ, NULL, bh1750_read, bh };
+    SimI2C_Device_t d_sps = { SPS30_I2C_ADDR, SPS30_MAX_SCL_HZ, NULL, sps30_read, sps };
+
+    sps->seq = 0;
+    bh->seq = 0;
+    SimI2C_Reset(I2CBUS_SM_HZ);
+    SimI2C_Attach(&d_bh);
+    SimI2C_Attach(&d_sps);
+    I2CBus_Init();
+}
+
+int main(void) {
+    SimSensor_t sps, bh;
+    Capture_Arena_t arena;
+    Capture_View_t view;
+    double t0, t_eager, t_capture, t_sim, t_validate, t_sparse, t_full;
+    int bad = 0;
+
+    // Cost of the simulated bus alone, subtracted from both capture paths
+    setup(&sps, &bh);
+    static uint8_t scratch[SPS30_MEASURED_FLOAT_LEN];
+    uint8_t cmd[2] = { 0x03, 0x00 };
+    t0 = HostClock_Ns();
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        I2CBus_Transmit(SPS30_I2C_ADDR, cmd, 2, HAL_MAX_DELAY);
+        I2CBus_Receive(SPS30_I2C_ADDR, scratch, SPS30_MEASURED_FLOAT_LEN, HAL_MAX_DELAY);
+        I2CBus_Receive(BH1750_ADDR, scratch, 2, HAL_MAX_DELAY);
+    }
+    t_sim = HostClock_Ns() - t0;
+
+    // Eager: CRC + convert while the burst is running
+    setup(&sps, &bh);
+    t0 = HostClock_Ns();
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        uint16_t raw;
+        bad += SPS30_ReadMeasuredValues(true, &eager_pm[i], NULL) != HAL_OK;
+        bad += BH1750_ReadRaw(&raw) != HAL_OK;
+        eager_lux[i] = BH1750_CalcLux(raw);
+    }
+    t_eager = HostClock_Ns() - t0 - t_sim;
+
+    // Capture: wire bytes straight into the arena
+    setup(&sps, &bh);
+    Capture_Init(&arena, arena_buf, sizeof(arena_buf));
+    t0 = HostClock_Ns();
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        bad += Capture_SPS30(&arena, true, (uint32_t)i) != HAL_OK;
+        bad += Capture_BH1750(&arena, (uint32_t)i) != HAL_OK;
+    }
+    t_capture = HostClock_Ns() - t0 - t_sim;
+
+    // Sparse read before validation: PM2.5 only, one field CRC pair each
+    uint32_t off = 0;
+    int n = 0;
+    t0 = HostClock_Ns();
+    while (Capture_Next(&arena, &off, &view) == HAL_OK) {
+        float v;
+        if (view.type == CAPTURE_SPS30_FLOAT) {
+            bad += Capture_ViewSPS30Float(&view, 1, &v) != HAL_OK;
+            bad += v != eager_pm[n].pm2_5;
+            sink = v;
+        }
+        else {
+            n++;
+        }
+    }
+    t_sparse = HostClock_Ns() - t0;
+
+    // Background pass, then a full read that skips per-field CRCs
+    t0 = HostClock_Ns();
+    while (Capture_Validate(&arena, 64) > 0)
+        ;
+    t_validate = HostClock_Ns() - t0;
+
+    off = 0;
+    n = 0;
+    t0 = HostClock_Ns();
+    while (Capture_Next(&arena, &off, &view) == HAL_OK) {
+        if (view.type == CAPTURE_SPS30_FLOAT) {
+            const float *ref = (const float *)&eager_pm[n];
+            for (uint8_t f = 0; f < 10; f++) {
+                float v;
+                bad += Capture_ViewSPS30Float(&view, f, &v) != HAL_OK;
+                bad += v != ref[f];
+            }
+        } else {
+            float lux;
+            bad += Capture_ViewLux(&view, &lux) != HAL_OK;
+            bad += lux != eager_lux[n];
+            n++;
+        }
+    }
+    t_full = HostClock_Ns() - t0;
+
+    printf("%d samples (SPS30 float frame + BH1750 count), CPU excluding simulated bus\n", NUM_SAMPLES);
+    printf("eager decode during burst   %7.1f ns/sample  %10.0f samples/s\n",
+           t_eager / NUM_SAMPLES, NUM_SAMPLES / (t_eager / 1e9));
+    printf("raw capture during burst    %7.1f ns/sample  %10.0f samples/s  (%u bytes arena)\n",
+           t_capture / NUM_SAMPLES, NUM_SAMPLES / (t_capture / 1e9), arena.used);
+    printf("later: PM2.5-only view      %7.1f ns/sample\n", t_sparse / NUM_SAMPLES);
+    printf("later: validate pass        %7.1f ns/sample\n", t_validate / NUM_SAMPLES);
+    printf("later: full view decode     %7.1f ns/sample\n", t_full / NUM_SAMPLES);
+    printf("%s\n", bad ? "MISMATCH" : "decoded values match eager path");
+
+    return bad != 0;
+}
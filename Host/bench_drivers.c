@@ -0,0 +1,473 @@
+/*
+ * bench_drivers.c
+ *
+ *  Microbenchmarks of the driver hot paths on the host, with the simulated
+ *  bus standing in for hi2c1. Reports ns/op and, where perf_event is
+ *  available, instructions/op.
+ *
+ *  Build:
+ *    gcc -O2 -std=c11 -IHost -ILibraries Host/bench_drivers.c Host/SimI2C.c Host/HostClock.c \
+ *        Libraries/I2CBus.c Libraries/BH1750.c Libraries/SPS30.c -o bench_drivers
+ *
+ *  Usage:
+ *    bench_drivers                       print results
+ *    bench_drivers --write FILE          also write FILE as the new baseline
+ *    bench_drivers --compare FILE [--threshold PCT] [--metric auto|ns|instr]
+ *                                        exit 1 when a path is more than PCT %
+ *                                        slower than FILE (default 10 for
+ *                                        instructions, 25 for ns)
+ *
+ *  auto (the default) gates on instructions/op and exits 2 when they cannot
+ *  be counted on either side. Wall-clock time is only comparable on a quiet,
+ *  dedicated machine: on shared VMs and containers whole runs land up to ~2x
+ *  apart, which no statistic inside one run removes. Pass --metric ns to
+ *  gate on the median ns/op anyway.
+ *
+ *  Baseline format, one line per path:  <name> <ns_per_op> <instr_per_op>
+ *  with instr_per_op = -1 when instructions could not be counted.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "SimI2C.h"
+#include "HostClock.h"
+#include "BH1750.h"
+#include "SPS30.h"
+
+#define TARGET_NS       20000000.0  // Time per measurement round
+#define ROUNDS          15          // Median of for ns, minimum of for instructions
+#define THRESHOLD_INSTR 10.0        // Default gate, %
+#define THRESHOLD_NS    25.0
+#define MAX_BASELINE    64
+
+typedef void (*Bench_Fn_t)(uint32_t iters);
+
+typedef struct {
+    const char *name;
+    Bench_Fn_t fn;
+    double ns_per_op;
+    double instr_per_op;
+} Bench_t;
+
+typedef struct {
+    char name[48];
+    double ns_per_op;
+    double instr_per_op;
+} Baseline_t;
+
+static volatile uint32_t sink;
+static uint8_t frame_float[SPS30_MEASURED_FLOAT_LEN];
+static uint8_t frame_u16[SPS30_MEASURED_U16_LEN];
+static uint8_t serial_frame[48];
+
+
+/* ---- instruction counter ---- */
+
+static int perf_fd = -1;
+
+static void counter_open(void) {
+#ifdef __linux__
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    perf_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+static void counter_start(void) {
+#ifdef __linux__
+    if (perf_fd >= 0) {
+        ioctl(perf_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+// Instructions since counter_start, or -1 without perf_event
+static double counter_stop(void) {
+#ifdef __linux__
+    uint64_t count;
+
+    if (perf_fd >= 0) {
+        ioctl(perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(perf_fd, &count, sizeof(count)) == sizeof(count))
+        	return (double)count;
+    }
+#endif
+    return -1.0;
+}
+
+
+/* ---- stubbed bus ---- */
+
+static HAL_StatusTypeDef sps30_read(void *ctx, uint8_t *data, uint16_t size) {
+    (void)ctx;
+
+    if (size == SPS30_MEASURED_FLOAT_LEN)
+    	memcpy(data, frame_float, size);
+    else if (size == SPS30_MEASURED_U16_LEN)
+    	memcpy(data, frame_u16, size);
+    else
+    	memcpy(data, serial_frame, size <= sizeof(serial_frame) ? size : sizeof(serial_frame));
+
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef bh1750_read(void *ctx, uint8_t *data, uint16_t size) {
+    (void)ctx;
+    (void)size;
+    data[0] = 0x12;
+    data[1] = 0x34;
+    return HAL_OK;
+}
+
+static void fixtures_init(void) {
+    SimI2C_Device_t bh = { BH1750_ADDR, BH1750_MAX_SCL_HZ, NULL, bh1750_read, NULL };
+    SimI2C_Device_t sps = { SPS30_I2C_ADDR, SPS30_MAX_SCL_HZ, NULL, sps30_read, NULL };
+    const char *serial = "3E1A0C2B7F9D4A51C6E80D3B";
+    float v[SIMI2C_SPS30_FLOAT_VALUES];
+
+    // Valid measured-value frames in both formats
+    for (int i = 0; i < 10; i++) {
+        v[i] = 12.5f + (float)i;
+
+        frame_u16[i*3]     = 0x00;
+        frame_u16[i*3 + 1] = 10 + i;
+        frame_u16[i*3 + 2] = SPS30_CalcCRC(&frame_u16[i*3], 2);
+    }
+    SimI2C_EncodeSPS30Float(v, frame_float);
+
+    // Serial number: ASCII pairs + CRC, zero padded
+    memset(serial_frame, 0, sizeof(serial_frame));
+    for (size_t i = 0, c = 0; i + 2 < sizeof(serial_frame); i += 3, c += 2) {
+        serial_frame[i]     = c < strlen(serial) ? serial[c] : 0;
+        serial_frame[i + 1] = c + 1 < strlen(serial) ? serial[c + 1] : 0;
+        serial_frame[i + 2] = SPS30_CalcCRC(&serial_frame[i], 2);
+    }
+
+    SimI2C_Reset(I2CBUS_SM_HZ);
+    SimI2C_Attach(&bh);
+    SimI2C_Attach(&sps);
+    I2CBus_Init();
+    BH1750_BusInit();
+    SPS30_BusInit();
+}
+
+
+/* ---- hot paths ---- */
+
+static void bench_crc_word(uint32_t iters) {
+    uint8_t word[2] = { 0x00, 0x5A };
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++) {
+        word[0] = (uint8_t)i;
+        acc += SPS30_CalcCRC(word, 2);
+    }
+    sink = acc;
+}
+
+static void bench_crc_frame(uint32_t iters) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++) {
+        frame_float[0] ^= (uint8_t)i;
+        acc += SPS30_CalcCRC(frame_float, SPS30_MEASURED_FLOAT_LEN);
+        frame_float[0] ^= (uint8_t)i;
+    }
+    sink = acc;
+}
+
+static void bench_decode_float(uint32_t iters) {
+    SPS30_Measurement_Float_t m;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++)
+        acc += SPS30_DecodeMeasuredValues(true, frame_float, &m, NULL) + (uint32_t)m.pm2_5;
+    sink = acc;
+}
+
+static void bench_decode_u16(uint32_t iters) {
+    SPS30_Measurement_U16_t m;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++)
+        acc += SPS30_DecodeMeasuredValues(false, frame_u16, NULL, &m) + m.pm2_5;
+    sink = acc;
+}
+
+static void bench_read_measured(uint32_t iters) {
+    SPS30_Measurement_Float_t m;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++)
+        acc += SPS30_ReadMeasuredValues(true, &m, NULL) + (uint32_t)m.pm10;
+    sink = acc;
+}
+
+static void bench_device_info(uint32_t iters) {
+    char serial[33];
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++)
+        acc += SPS30_GetSerialNumber(serial) + (uint8_t)serial[5];
+    sink = acc;
+}
+
+static void bench_calc_lux(uint32_t iters) {
+    float acc = 0.0f;
+    for (uint32_t i = 0; i < iters; i++)
+        acc += BH1750_CalcLux((uint16_t)i);
+    sink = (uint32_t)acc;
+}
+
+static void bench_read_raw(uint32_t iters) {
+    uint16_t raw;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++)
+        acc += BH1750_ReadRaw(&raw) + raw;
+    sink = acc;
+}
+
+// Every path must succeed on the fixtures, otherwise an early error return is being timed
+static int fixtures_check(void) {
+    SPS30_Measurement_Float_t f;
+    SPS30_Measurement_U16_t u;
+    char serial[33];
+    uint16_t raw;
+    int bad = 0;
+
+    bad += SPS30_DecodeMeasuredValues(true, frame_float, &f, NULL) != HAL_OK || f.pm2_5 != 13.5f;
+    bad += SPS30_DecodeMeasuredValues(false, frame_u16, NULL, &u) != HAL_OK || u.pm2_5 != 11;
+    bad += SPS30_ReadMeasuredValues(true, &f, NULL) != HAL_OK;
+    bad += SPS30_GetSerialNumber(serial) != HAL_OK || strcmp(serial, "3E1A0C2B7F9D4A51C6E80D3B") != 0;
+    bad += BH1750_ReadRaw(&raw) != HAL_OK || raw != 0x1234;
+
+    return bad;
+}
+
+static Bench_t benches[] = {
+    { "sps30_calc_crc_word",      bench_crc_word,      0, 0 },
+    { "sps30_calc_crc_frame60",   bench_crc_frame,     0, 0 },
+    { "sps30_decode_float",       bench_decode_float,  0, 0 },
+    { "sps30_decode_u16",         bench_decode_u16,    0, 0 },
+    { "sps30_read_measured_float", bench_read_measured, 0, 0 },
+    { "sps30_read_device_info",   bench_device_info,   0, 0 },
+    { "bh1750_calc_lux",          bench_calc_lux,      0, 0 },
+    { "bh1750_read_raw",          bench_read_raw,      0, 0 },
+};
+#define NUM_BENCHES (sizeof(benches) / sizeof(benches[0]))
+
+
+// Iterations for one round of about TARGET_NS
+static uint32_t bench_calibrate(const Bench_t *b) {
+    uint32_t iters = 1;
+
+    // Grow the iteration count until one round takes a measurable time
+    for (;;) {
+        double t0 = HostClock_Ns();
+        b->fn(iters);
+        double dt = HostClock_Ns() - t0;
+        if (dt > TARGET_NS / 10 || iters > (1u << 30))
+        	break;
+        iters *= 2;
+    }
+    return iters * 10;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void bench_run(Bench_t *b) {
+    double ns[ROUNDS];
+
+    b->instr_per_op = -1;
+    for (int r = 0; r < ROUNDS; r++) {
+        // Recalibrated every round so a slow calibration does not fix the round length for all of them
+        uint32_t iters = bench_calibrate(b);
+
+        counter_start();
+        double t0 = HostClock_Ns();
+        b->fn(iters);
+        ns[r] = (HostClock_Ns() - t0) / iters;
+        double instr = counter_stop();
+
+        if (instr >= 0 && (b->instr_per_op < 0 || instr / iters < b->instr_per_op))
+        	b->instr_per_op = instr / iters;
+    }
+
+    qsort(ns, ROUNDS, sizeof(ns[0]), cmp_double);
+    b->ns_per_op = ns[ROUNDS / 2];
+}
+
+// Instruction counts on every path of both runs
+static bool instr_available(const Baseline_t *base, int n_base) {
+    for (size_t i = 0; i < NUM_BENCHES; i++) {
+        if (benches[i].instr_per_op <= 0)
+        	return false;
+    }
+    for (int j = 0; j < n_base; j++) {
+        if (base[j].instr_per_op <= 0)
+        	return false;
+    }
+    return true;
+}
+
+static int baseline_load(const char *path, Baseline_t *out, int max) {
+    FILE *f = fopen(path, "r");
+    char line[128];
+    int n = 0;
+
+    if (f == NULL)
+    	return -1;
+
+    while (n < max && fgets(line, sizeof(line), f) != NULL) {
+        if (line[0] == '#' || line[0] == '\n')
+        	continue;
+        if (sscanf(line, "%47s %lf %lf", out[n].name, &out[n].ns_per_op, &out[n].instr_per_op) == 3)
+        	n++;
+    }
+
+    fclose(f);
+    return n;
+}
+
+static int baseline_write(const char *path) {
+    FILE *f = fopen(path, "w");
+
+    if (f == NULL)
+    	return -1;
+
+    fprintf(f, "# name ns_per_op instr_per_op\n");
+    for (size_t i = 0; i < NUM_BENCHES; i++)
+        fprintf(f, "%s %.3f %.1f\n", benches[i].name, benches[i].ns_per_op, benches[i].instr_per_op);
+
+    fclose(f);
+    return 0;
+}
+
+// Returns the number of regressed paths
+static int baseline_compare(const Baseline_t *base, int n_base, double threshold, const char *metric) {
+    int regressions = 0;
+
+    printf("\n%-28s %12s %12s %8s\n", "path", "baseline", "current", "delta");
+    for (size_t i = 0; i < NUM_BENCHES; i++) {
+        const Bench_t *b = &benches[i];
+        const Baseline_t *ref = NULL;
+
+        for (int j = 0; j < n_base; j++) {
+            if (strcmp(base[j].name, b->name) == 0)
+            	ref = &base[j];
+        }
+        if (ref == NULL) {
+            printf("%-28s %12s\n", b->name, "new");
+            continue;
+        }
+
+        // Instructions are far less noisy than time, use them unless ns was asked for
+        bool use_instr = strcmp(metric, "ns") != 0 && ref->instr_per_op > 0 && b->instr_per_op > 0;
+        if (strcmp(metric, "ns") != 0 && !use_instr) {
+            printf("%-28s %12s\n", b->name, "no instr");
+            regressions++;
+            continue;
+        }
+
+        double old_v = use_instr ? ref->instr_per_op : ref->ns_per_op;
+        double new_v = use_instr ? b->instr_per_op : b->ns_per_op;
+        double delta = 100.0 * (new_v - old_v) / old_v;
+        bool fail = delta > threshold;
+
+        printf("%-28s %12.2f %12.2f %+7.1f%% %s%s\n", b->name, old_v, new_v, delta,
+               use_instr ? "instr" : "ns", fail ? "  REGRESSION" : "");
+        regressions += fail;
+    }
+
+    return regressions;
+}
+
+int main(int argc, char **argv) {
+    const char *write_path = NULL, *compare_path = NULL, *metric = "auto";
+    double threshold = -1.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--write") == 0 && i + 1 < argc)
+        	write_path = argv[++i];
+        else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc)
+        	compare_path = argv[++i];
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+        	threshold = atof(argv[++i]);
+        else if (strcmp(argv[i], "--metric") == 0 && i + 1 < argc)
+        	metric = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--write FILE] [--compare FILE] [--threshold PCT] [--metric auto|ns|instr]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (strcmp(metric, "auto") != 0 && strcmp(metric, "ns") != 0 && strcmp(metric, "instr") != 0) {
+        fprintf(stderr, "unknown metric '%s', expected auto, ns or instr\n", metric);
+        return 2;
+    }
+
+    counter_open();
+    fixtures_init();
+    if (fixtures_check() != 0) {
+        fprintf(stderr, "fixture check failed\n");
+        return 2;
+    }
+
+    printf("%-28s %12s %12s\n", "path", "ns/op", "instr/op");
+    for (size_t i = 0; i < NUM_BENCHES; i++) {
+        bench_run(&benches[i]);
+        if (benches[i].instr_per_op >= 0)
+        	printf("%-28s %12.2f %12.1f\n", benches[i].name, benches[i].ns_per_op, benches[i].instr_per_op);
+        else
+        	printf("%-28s %12.2f %12s\n", benches[i].name, benches[i].ns_per_op, "n/a");
+    }
+
+    if (write_path != NULL && baseline_write(write_path) != 0) {
+        fprintf(stderr, "cannot write %s\n", write_path);
+        return 2;
+    }
+
+    if (compare_path != NULL) {
+        Baseline_t base[MAX_BASELINE];
+        int n = baseline_load(compare_path, base, MAX_BASELINE);
+
+        if (n < 0) {
+            fprintf(stderr, "cannot read %s\n", compare_path);
+            return 2;
+        }
+
+        if (strcmp(metric, "ns") != 0 && !instr_available(base, n)) {
+            fprintf(stderr, "instruction counts unavailable, not gating on wall-clock time; "
+                            "pass --metric ns to compare median ns/op\n");
+            return 2;
+        }
+
+        if (threshold < 0)
+        	threshold = (strcmp(metric, "ns") == 0) ? THRESHOLD_NS : THRESHOLD_INSTR;
+
+        int regressions = baseline_compare(base, n, threshold, metric);
+        printf("%d path(s) regressed by more than %.1f%%\n", regressions, threshold);
+        return regressions ? 1 : 0;
+    }
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * bench_i2c.c
+ *
+ *  Bus time of a mixed BH1750 / SPS30 workload on the simulated bus:
+ *  everything at 100 kHz, per-device rate switching, and switching with
+ *  queued transactions grouped by rate.
+ *
+ *  Build:
+ *    gcc -O2 -std=c11 -IHost -ILibraries Host/bench_i2c.c Host/SimI2C.c \
+ *        Libraries/I2CBus.c Libraries/BH1750.c Libraries/SPS30.c -o bench_i2c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#include <stdio.h>
+
+#include "SimI2C.h"
+#include "I2CBus.h"
+#include "BH1750.h"
+#include "SPS30.h"
+
+#define CYCLES          1000    // One cycle: BH1750 one-time L-res read + SPS30 data-ready poll
+#define SPS30_READ_EVERY 10     // Cycles per SPS30 measured-values read
+#define BATCH_CYCLES    5       // Cycles queued before one I2CBus_Flush
+
+// SPS30 answers with valid CRCs so the driver path runs to completion
+static HAL_StatusTypeDef sps30_read(void *ctx, uint8_t *data, uint16_t size) {
+    (void)ctx;
+    for (uint16_t i = 0; i + 2 < size; i += 3) {
+        data[i] = 0x00;
+        data[i + 1] = 0x01;
+        data[i + 2] = SPS30_CalcCRC(&data[i], 2);
+    }
+    return HAL_OK;
+}
+
+static void attach_devices(void) {
+    SimI2C_Device_t bh = { BH1750_ADDR, BH1750_MAX_SCL_HZ, NULL, NULL, NULL };
+    SimI2C_Device_t sps = { SPS30_I2C_ADDR, SPS30_MAX_SCL_HZ, NULL, sps30_read, NULL };
+
+    SimI2C_Reset(I2CBUS_SM_HZ);
+    SimI2C_Attach(&bh);
+    SimI2C_Attach(&sps);
+    I2CBus_Init();
+}
+
+// Blocking driver calls, in the order an application loop issues them
+static void run_blocking(void) {
+    SPS30_Measurement_Float_t pm;
+    uint16_t raw;
+    uint8_t ready;
+
+    for (int c = 0; c < CYCLES; c++) {
+        BH1750_SetMode(BH1750_ONE_L_RES_MODE);
+        BH1750_ReadRaw(&raw);
+        SPS30_ReadDataReady(&ready);
+        if ((c % SPS30_READ_EVERY) == SPS30_READ_EVERY - 1)
+            SPS30_ReadMeasuredValues(true, &pm, NULL);
+    }
+}
+
+static int submit(I2CBus_Txn_t *txn, uint16_t addr, I2CBus_Dir_t dir, uint8_t *data, uint16_t size) {
+    *txn = (I2CBus_Txn_t){ addr, dir, data, size, HAL_MAX_DELAY, HAL_OK };
+    return I2CBus_Submit(txn) != HAL_OK;
+}
+
+// Same transactions, queued and flushed every BATCH_CYCLES cycles
+static int run_batched(void) {
+    static I2CBus_Txn_t txn[I2CBUS_QUEUE_LEN];
+    static uint8_t bh_mode = BH1750_ONE_L_RES_MODE;
+    static uint8_t bh_rx[2], sps_cmd_ready[2] = { 0x02, 0x02 }, sps_cmd_read[2] = { 0x03, 0x00 };
+    static uint8_t sps_rx_ready[3], sps_rx_values[60];
+
+    int errors = 0;
+
+    for (int c = 0; c < CYCLES; c += BATCH_CYCLES) {
+        uint16_t n = 0;
+
+        for (int k = c; k < c + BATCH_CYCLES; k++) {
+            errors += submit(&txn[n++], BH1750_ADDR, I2CBUS_WRITE, &bh_mode, 1);
+            errors += submit(&txn[n++], BH1750_ADDR, I2CBUS_READ, bh_rx, 2);
+            errors += submit(&txn[n++], SPS30_I2C_ADDR, I2CBUS_WRITE, sps_cmd_ready, 2);
+            errors += submit(&txn[n++], SPS30_I2C_ADDR, I2CBUS_READ, sps_rx_ready, 3);
+            if ((k % SPS30_READ_EVERY) == SPS30_READ_EVERY - 1) {
+                errors += submit(&txn[n++], SPS30_I2C_ADDR, I2CBUS_WRITE, sps_cmd_read, 2);
+                errors += submit(&txn[n++], SPS30_I2C_ADDR, I2CBUS_READ, sps_rx_values, 60);
+            }
+        }
+
+        errors += I2CBus_Flush() != HAL_OK;
+    }
+
+    return errors;
+}
+
+static uint64_t report(const char *name, uint64_t baseline_ns) {
+    SimI2C_Stats_t s;
+    SimI2C_GetStats(&s);
+
+    uint64_t total = s.bus_ns + s.reinit_ns;
+    printf("%-26s bus %8.2f ms  reinit %6.2f ms (%5u)  total %8.2f ms",
+           name, s.bus_ns / 1e6, s.reinit_ns / 1e6, s.reinits, total / 1e6);
+    if (baseline_ns)
+        printf("  saved %5.1f%%", 100.0 * (double)(baseline_ns - total) / (double)baseline_ns);
+    if (s.violations)
+        printf("  RATE VIOLATIONS %u", s.violations);
+    printf("\n");
+
+    return total;
+}
+
+int main(void) {
+    SimI2C_Stats_t s;
+    uint64_t baseline;
+    int failed = 0;
+
+    printf("%d cycles of BH1750 read + SPS30 poll, SPS30 values every %d cycles, %u ns per re-init\n",
+           CYCLES, SPS30_READ_EVERY, SIMI2C_REINIT_NS);
+
+    // 1. Shared static 100 kHz: nothing registered
+    attach_devices();
+    run_blocking();
+    baseline = report("static 100 kHz", 0);
+
+    // 2. Per-device rate, blocking driver calls
+    attach_devices();
+    BH1750_BusInit();
+    SPS30_BusInit();
+    run_blocking();
+    report("per-device rate", baseline);
+    SimI2C_GetStats(&s);
+    failed |= s.violations != 0;
+
+    // 3. Per-device rate, queued and grouped
+    attach_devices();
+    BH1750_BusInit();
+    SPS30_BusInit();
+    failed |= run_batched();
+    report("per-device rate, batched", baseline);
+    SimI2C_GetStats(&s);
+    failed |= s.violations != 0;
+
+    return failed;
+}
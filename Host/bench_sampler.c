@@ -0,0 +1,247 @@
+/*
+ * bench_sampler.c
+ *
+ *  Sample timing of an application loop calling the drivers directly
+ *  against the timer-driven Sampler, on the simulated bus and clock.
+ *  Both sensors see a known signal, so the timestamp error shows up as
+ *  a value error against the truth at the reported time. The SPS30 latches
+ *  one measurement per second on its own, slightly slow clock.
+ *  Exits non-zero on sampler errors, overruns or unaligned timeline points.
+ *
+ *  Build:
+ *    gcc -O2 -std=c11 -IHost -ILibraries Host/bench_sampler.c Host/SimI2C.c \
+ *        Libraries/Sampler.c Libraries/I2CBus.c Libraries/BH1750.c Libraries/SPS30.c -lm -o bench_sampler
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SimI2C.h"
+#include "Sampler.h"
+
+#define RUN_S           600
+#define TICK_US         1000u   // 1 kHz sampling timer
+#define BH1750_PERIOD   200     // ticks, > 120 ms H-res conversion
+#define SPS30_PERIOD    100     // ticks, data-ready poll
+#define ALIGN_PERIOD    1000    // ticks between timeline points
+#define SPS30_OUTPUT_NS 1000300000ull   // Sensor's own 1 s clock, running slightly slow
+#define SPS30_PHASE_NS  370000000ull    // First measurement after start
+#define PI_F            3.14159265f
+
+typedef struct {
+    double sum2;
+    double max;
+    uint32_t n;
+} ErrStat_t;
+
+// SPS30 model: latches one measurement per output period, data-ready until read
+typedef struct {
+    uint16_t cmd;
+    uint64_t latched;       // Measurements produced so far
+    bool ready;
+    float pm;
+} SimSPS30_t;
+
+static SimSPS30_t sps30;
+
+
+static float truth_lux(uint64_t us) {
+    return 500.0f + 400.0f * sinf(2.0f * PI_F * (float)(us % 7000000u) / 7e6f);
+}
+
+static float truth_pm25(uint64_t us) {
+    return 20.0f + 15.0f * sinf(2.0f * PI_F * (float)(us % 11000000u) / 11e6f);
+}
+
+// Sensors return the signal at the moment the read happens
+static HAL_StatusTypeDef bh1750_read(void *ctx, uint8_t *data, uint16_t size) {
+    uint16_t raw = (uint16_t)(truth_lux(SimI2C_NowNs() / 1000) * 1.2f + 0.5f);
+    (void)ctx;
+    (void)size;
+
+    data[0] = raw >> 8;
+    data[1] = raw & 0xFF;
+    return HAL_OK;
+}
+
+static void sps30_update(SimSPS30_t *s) {
+    uint64_t now = SimI2C_NowNs();
+    uint64_t n = (now < SPS30_PHASE_NS) ? 0 : (now - SPS30_PHASE_NS) / SPS30_OUTPUT_NS + 1;
+
+    if (n == s->latched)
+    	return;
+
+    // Signal at the moment the newest measurement was produced
+    s->latched = n;
+    s->ready = true;
+    s->pm = truth_pm25((SPS30_PHASE_NS + (n - 1) * SPS30_OUTPUT_NS) / 1000);
+}
+
+static HAL_StatusTypeDef sps30_write(void *ctx, const uint8_t *data, uint16_t size) {
+    SimSPS30_t *s = (SimSPS30_t *)ctx;
+
+    if (size >= 2)
+    	s->cmd = ((uint16_t)data[0] << 8) | data[1];
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef sps30_read(void *ctx, uint8_t *data, uint16_t size) {
+    SimSPS30_t *s = (SimSPS30_t *)ctx;
+
+    sps30_update(s);
+    memset(data, 0, size);
+
+    if (s->cmd == SPS30_CMD_READ_DATA_READY_FLAG && size == 3) {
+        data[1] = s->ready;
+        data[2] = SPS30_CalcCRC(data, 2);
+    } else if (s->cmd == SPS30_CMD_READ_MEASURED_VALUES && size == SPS30_MEASURED_FLOAT_LEN) {
+        float v[SIMI2C_SPS30_FLOAT_VALUES];
+        for (uint8_t i = 0; i < SIMI2C_SPS30_FLOAT_VALUES; i++)
+            v[i] = s->pm;
+        SimI2C_EncodeSPS30Float(v, data);
+        s->ready = false;
+    }
+    return HAL_OK;
+}
+
+/* The simulated update interrupt is serviced from the main loop, so the
+   counter can run more than one period past the last serviced tick. It is
+   reported against one pending update, which keeps the time exact. */
+uint32_t Sampler_TimerCounterUs(bool *update_pending) {
+    uint64_t since = SimI2C_NowNs() / 1000 - (uint64_t)Sampler_GetTicks() * TICK_US;
+
+    *update_pending = since >= TICK_US;
+    return (uint32_t)(*update_pending ? since - TICK_US : since);
+}
+
+static void setup(void) {
+    SimI2C_Device_t bh = { BH1750_ADDR, BH1750_MAX_SCL_HZ, NULL, bh1750_read, NULL };
+    SimI2C_Device_t sps = { SPS30_I2C_ADDR, SPS30_MAX_SCL_HZ, sps30_write, sps30_read, &sps30 };
+
+    memset(&sps30, 0, sizeof(sps30));
+    SimI2C_Reset(I2CBUS_SM_HZ);
+    SimI2C_Attach(&bh);
+    SimI2C_Attach(&sps);
+    I2CBus_Init();
+    BH1750_BusInit();
+    SPS30_BusInit();
+    srand(7);
+}
+
+// Other application work between sensor reads, 0..max_us
+static void app_work(uint32_t max_us) {
+    SimI2C_AdvanceNs((uint64_t)(rand() % (max_us + 1)) * 1000u);
+}
+
+static void err_add(ErrStat_t *e, double err) {
+    e->sum2 += err * err;
+    if (fabs(err) > e->max) e->max = fabs(err);
+    e->n++;
+}
+
+static void err_print(const char *name, const ErrStat_t *e) {
+    printf("  %-34s rms %8.3f  max %8.3f  (%u samples)\n", name, sqrt(e->sum2 / e->n), e->max, e->n);
+}
+
+// Application loop as it is written today: blocking reads, timestamp taken before them
+static void run_adhoc(void) {
+    ErrStat_t lux_err = { 0 }, pm_err = { 0 }, interval = { 0 };
+    uint32_t prev = 0;
+
+    setup();
+    SPS30_StartMeasurement(0x03);
+
+    while (SimI2C_NowNs() < (uint64_t)RUN_S * 1000000000ull) {
+        SPS30_Measurement_Float_t pm;
+        float lux;
+        uint32_t t = HAL_GetTick();
+
+        BH1750_ReadLux(BH1750_CONT_H_RES_MODE, &lux);
+        SPS30_ReadMeasuredValues(true, &pm, NULL);
+
+        err_add(&lux_err, lux - truth_lux((uint64_t)t * 1000));
+        err_add(&pm_err, pm.pm2_5 - truth_pm25((uint64_t)t * 1000));
+        if (prev != 0)
+            err_add(&interval, 1000.0 * ((double)(t - prev) - 1000.0));
+        prev = t;
+
+        app_work(100000);
+        HAL_Delay(1000);
+    }
+
+    printf("direct driver calls, 1 s loop\n");
+    err_print("interval deviation from 1 s (us)", &interval);
+    err_print("lux error at reported time", &lux_err);
+    err_print("PM2.5 error at reported time", &pm_err);
+}
+
+static int run_sampler(void) {
+    ErrStat_t lux_err = { 0 }, pm_err = { 0 };
+    Sampler_Jitter_t j;
+    Sampler_Sample_t bh_last, sps_last;
+    uint8_t bh_id, sps_id;
+    uint64_t next_tick_ns = TICK_US * 1000ull;
+    uint64_t align_us = 2ull * ALIGN_PERIOD * TICK_US;
+    uint32_t align_failed = 0;
+    int failed = 0;
+
+    setup();
+    SPS30_StartMeasurement(0x03);
+    BH1750_PowerOn();
+    BH1750_SetMode(BH1750_CONT_H_RES_MODE);
+
+    Sampler_Init(TICK_US);
+    Sampler_Register("BH1750", BH1750_PERIOD, Sampler_AcquireBH1750, NULL, 1, &bh_id);
+    Sampler_Register("SPS30", SPS30_PERIOD, Sampler_AcquireSPS30, NULL, 10, &sps_id);
+
+    while (SimI2C_NowNs() < (uint64_t)RUN_S * 1000000000ull) {
+        // Timer interrupts due by now
+        while (SimI2C_NowNs() >= next_tick_ns) {
+            Sampler_TimerTick();
+            next_tick_ns += TICK_US * 1000ull;
+        }
+
+        Sampler_Process();
+
+        // Both devices onto the common timeline once each has a sample past the timeline point
+        if (Sampler_GetLatest(bh_id, &bh_last) == HAL_OK && bh_last.timestamp_us > align_us &&
+            Sampler_GetLatest(sps_id, &sps_last) == HAL_OK && sps_last.timestamp_us > align_us) {
+            float lux, pm[SAMPLER_MAX_VALUES];
+            if (Sampler_Align(bh_id, align_us, &lux) == HAL_OK &&
+                Sampler_Align(sps_id, align_us, pm) == HAL_OK) {
+                err_add(&lux_err, lux - truth_lux(align_us));
+                err_add(&pm_err, pm[1] - truth_pm25(align_us));
+            } else {
+                align_failed++;
+            }
+            align_us += (uint64_t)ALIGN_PERIOD * TICK_US;
+        }
+
+        app_work(3000);
+    }
+
+    printf("Sampler, %u us tick, main loop work up to 3 ms\n", TICK_US);
+    for (uint8_t id = 0; id < 2; id++) {
+        Sampler_GetJitter(id, &j);
+        printf("  %-7s latency mean %7.1f us  min %5u  max %5u   interval rms %7.1f us  max %5u   "
+               "overruns %u  errors %u  (%u samples)\n",
+               id == bh_id ? "BH1750" : "SPS30", j.latency_mean_us, j.latency_min_us, j.latency_max_us,
+               j.interval_rms_us, j.interval_max_us, j.overruns, j.errors, j.samples);
+        failed |= j.errors != 0 || j.overruns != 0 || j.samples == 0;
+    }
+    err_print("lux error, aligned to timeline", &lux_err);
+    err_print("PM2.5 error, aligned to timeline", &pm_err);
+    if (align_failed)
+        printf("  %u timeline points not bracketed by samples\n", align_failed);
+
+    return failed || align_failed != 0 || lux_err.n == 0;
+}
+
+int main(void) {
+    run_adhoc();
+    return run_sampler();
+}
@@ -0,0 +1,171 @@
+/*
+ * bench_store.c
+ *
+ *  Query latency of SensorStore against a linear scan of raw samples.
+ *
+ *  Build:
+ *    gcc -O2 -std=c11 -IHost -ILibraries Host/bench_store.c Host/SimFlash.c \
+ *        Host/HostClock.c Libraries/SensorStore.c -lm -o bench_store
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "SensorStore.h"
+#include "SimFlash.h"
+#include "HostClock.h"
+
+#define PAGE_SIZE       2048u
+#define MINUTE_PAGES    160u    // > 1 day of minute buckets
+#define HOUR_PAGES      80u     // > 31 days of hour buckets
+#define DAY_PAGES       40u     // > 1 year of day buckets
+#define FLASH_SIZE      ((MINUTE_PAGES + HOUR_PAGES + DAY_PAGES) * PAGE_SIZE)
+
+#define SAMPLE_PERIOD_S 10u
+#define RUN_DAYS        31u
+#define NUM_SAMPLES     (RUN_DAYS * SENSORSTORE_DAY_S / SAMPLE_PERIOD_S)
+#define QUERY_REPEAT    200
+
+typedef struct {
+    uint32_t timestamp;
+    SPS30_Measurement_Float_t pm;
+    float lux;
+} RawLog_t;
+
+static uint8_t flash_mem[FLASH_SIZE];
+static SensorStore_Rollup_t out[2048];
+static SensorStore_Rollup_t naive_out[2048];
+
+// Reference: bucket every raw sample whose bucket overlaps [from, to] by scanning the whole log
+static uint32_t naive_query(const RawLog_t *log, uint32_t n, uint32_t width, uint32_t from, uint32_t to) {
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        const float *pm = (const float *)&log[i].pm;
+        uint32_t start = log[i].timestamp - (log[i].timestamp % width);
+
+        if (start + width <= from || start > to)
+        	continue;
+
+        if (count == 0 || naive_out[count - 1].start != start) {
+            memset(&naive_out[count], 0, sizeof(naive_out[count]));
+            naive_out[count++].start = start;
+        }
+
+        SensorStore_Rollup_t *b = &naive_out[count - 1];
+        for (int c = 0; c < SENSORSTORE_NUM_CHANNELS; c++) {
+            float v = (c == SENSORSTORE_CH_LUX) ? log[i].lux : pm[c];
+            if (b->ch[c].count == 0 || v < b->ch[c].min) b->ch[c].min = v;
+            if (b->ch[c].count == 0 || v > b->ch[c].max) b->ch[c].max = v;
+            b->ch[c].sum += v;
+            b->ch[c].count++;
+        }
+    }
+
+    return count;
+}
+
+static int bench(const char *name, SensorStore_t *store, SimFlash_t *flash, const RawLog_t *log,
+                 SensorStore_Tier_t tier, uint32_t width, SensorStore_Channel_t ch, uint32_t from, uint32_t to) {
+    uint32_t n = 0, naive_n = 0;
+    double t0, t_store, t_naive;
+
+    SimFlash_ResetCounters(flash);
+    t0 = HostClock_Ns();
+    for (int r = 0; r < QUERY_REPEAT; r++) {
+        if (SensorStore_Query(store, tier, from, to, out, 2048, &n) != HAL_OK) {
+            printf("%s: query failed\n", name);
+            return 1;
+        }
+    }
+    t_store = (HostClock_Ns() - t0) / QUERY_REPEAT;
+
+    t0 = HostClock_Ns();
+    for (int r = 0; r < QUERY_REPEAT / 20; r++)
+        naive_n = naive_query(log, NUM_SAMPLES, width, from, to);
+    t_naive = (HostClock_Ns() - t0) / (QUERY_REPEAT / 20);
+
+    // Cross-check the rollups against the raw scan
+    uint32_t mismatches = (n != naive_n);
+    for (uint32_t i = 0; i < n && i < naive_n; i++) {
+        if (out[i].start != naive_out[i].start || out[i].ch[ch].count != naive_out[i].ch[ch].count ||
+            fabsf(SensorStore_Mean(&out[i], ch) - SensorStore_Mean(&naive_out[i], ch)) > 1e-2f)
+            mismatches++;
+    }
+
+    printf("%-28s buckets=%5u  store=%10.0f ns  (%5.1f flash reads)  raw scan=%12.0f ns  speedup=%7.1fx  %s\n",
+           name, n, t_store, (double)flash->reads / QUERY_REPEAT, t_naive, t_naive / t_store,
+           mismatches ? "MISMATCH" : "ok");
+
+    return mismatches != 0;
+}
+
+int main(void) {
+    SimFlash_t flash;
+    SensorStore_Flash_t backend;
+    SensorStore_t *store = malloc(sizeof(SensorStore_t));
+    RawLog_t *log = malloc(sizeof(RawLog_t) * NUM_SAMPLES);
+    const SensorStore_TierConfig_t tiers[SENSORSTORE_NUM_TIERS] = {
+        { 0,                                     MINUTE_PAGES },
+        { MINUTE_PAGES * PAGE_SIZE,              HOUR_PAGES },
+        { (MINUTE_PAGES + HOUR_PAGES) * PAGE_SIZE, DAY_PAGES },
+    };
+    int failed = 0;
+
+    SimFlash_Init(&flash, flash_mem, FLASH_SIZE, PAGE_SIZE);
+    SimFlash_GetBackend(&flash, &backend);
+    if (SensorStore_Init(store, &backend, tiers, true) != HAL_OK) {
+        printf("init failed\n");
+        return 1;
+    }
+
+    // Synthetic diurnal signal, small integers keep the float sums exact
+    srand(1);
+    double t0 = HostClock_Ns();
+    for (uint32_t i = 0; i < NUM_SAMPLES; i++) {
+        uint32_t ts = i * SAMPLE_PERIOD_S;
+        float *pm = (float *)&log[i].pm;
+
+        log[i].timestamp = ts;
+        for (int c = 0; c < SENSORSTORE_SPS30_CHANNELS; c++)
+            pm[c] = (float)(5 + c + rand() % 16);
+        log[i].lux = (float)((ts / 60) % 1000);
+
+        SensorStore_AddSPS30(store, ts, &log[i].pm);
+        SensorStore_AddLux(store, ts, log[i].lux);
+    }
+    double t_ingest = (HostClock_Ns() - t0) / NUM_SAMPLES;
+
+    printf("ingested %u samples, %.0f ns/sample, %u erases, %u programs\n",
+           NUM_SAMPLES, t_ingest, flash.erases, flash.programs);
+
+    uint32_t end = (NUM_SAMPLES - 1) * SAMPLE_PERIOD_S;
+    failed |= bench("PM2.5 per minute, last day", store, &flash, log, SENSORSTORE_TIER_MINUTE, SENSORSTORE_MINUTE_S,
+                    SENSORSTORE_CH_PM2_5, end - SENSORSTORE_DAY_S + 1, end);
+    failed |= bench("PM2.5 per minute, last hour", store, &flash, log, SENSORSTORE_TIER_MINUTE, SENSORSTORE_MINUTE_S,
+                    SENSORSTORE_CH_PM2_5, end - SENSORSTORE_HOUR_S + 1, end);
+    failed |= bench("lux per hour, last month", store, &flash, log, SENSORSTORE_TIER_HOUR, SENSORSTORE_HOUR_S,
+                    SENSORSTORE_CH_LUX, 0, end);
+    failed |= bench("lux per day, last month", store, &flash, log, SENSORSTORE_TIER_DAY, SENSORSTORE_DAY_S,
+                    SENSORSTORE_CH_LUX, 0, end);
+
+    // Remount from flash and make sure the tiers come back intact
+    SensorStore_Flush(store);
+    SensorStore_TierState_t before = store->tier[SENSORSTORE_TIER_HOUR];
+    if (SensorStore_Init(store, &backend, tiers, false) != HAL_OK ||
+        store->tier[SENSORSTORE_TIER_HOUR].first != before.first ||
+        store->tier[SENSORSTORE_TIER_HOUR].next != before.next) {
+        printf("remount: MISMATCH\n");
+        failed = 1;
+    } else {
+        printf("remount: ok\n");
+    }
+
+    free(log);
+    free(store);
+    return failed;
+}
@@ -0,0 +1,172 @@
+/*
+ * bench_telemetry.c
+ *
+ *  Bytes per sample and encode cost of batched Telemetry frames against
+ *  one text message per sample.
+ *
+ *  Build:
+ *    gcc -O2 -std=c11 -IHost -ILibraries Host/bench_telemetry.c Host/HostClock.c \
+ *        Libraries/Telemetry.c -o bench_telemetry
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#include "Telemetry.h"
+#include "HostClock.h"
+
+#define NUM_SAMPLES     20000
+#define MTU             242     // LoRaWAN DR5 payload
+#define NAIVE_HEADER    6       // Per-message header: version, type, timestamp
+
+typedef struct {
+    uint32_t ts_ms;
+    SPS30_Measurement_Float_t pm;
+    float lux;
+} Sample_t;
+
+static uint8_t frame[MTU];
+static char naive_buf[256];
+static volatile uint32_t sink;
+
+static uint64_t cycles(void) {
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void report(const char *name, uint64_t bytes, uint32_t frames, double ns, uint64_t cyc) {
+    printf("%-22s %7.2f bytes/sample  %6u frames  %7.1f ns/sample", name,
+           (double)bytes / NUM_SAMPLES, frames, ns / NUM_SAMPLES);
+#ifdef HAVE_TSC
+    printf("  %7.1f cycles/sample", (double)cyc / NUM_SAMPLES);
+#endif
+    printf("\n");
+}
+
+// Baseline: every sample goes out on its own as a text line
+static void bench_naive(const Sample_t *s) {
+    uint64_t bytes = 0;
+    double t0 = HostClock_Ns();
+    uint64_t c0 = cycles();
+
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        const SPS30_Measurement_Float_t *pm = &s[i].pm;
+        int n = snprintf(naive_buf, sizeof(naive_buf),
+                         "%lu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.1f\n",
+                         (unsigned long)s[i].ts_ms, pm->pm1_0, pm->pm2_5, pm->pm4_0, pm->pm10,
+                         pm->nc0_5, pm->nc1_0, pm->nc2_5, pm->nc4_0, pm->nc10, pm->typical_size, s[i].lux);
+        bytes += NAIVE_HEADER + n;
+        sink += naive_buf[0];
+    }
+
+    uint64_t cyc = cycles() - c0;
+    report("per-sample text", bytes, NUM_SAMPLES, HostClock_Ns() - t0, cyc);
+}
+
+typedef struct {
+    uint64_t bytes;
+    uint32_t frames;
+    double t_check;
+    int next_check;
+    int bad;
+} BatchStats_t;
+
+// Close the frame, account for it and decode it back against the source samples
+static void flush_frame(Telemetry_Encoder_t *enc, const Sample_t *s, int upto, const float *deadband, BatchStats_t *st) {
+    uint16_t len = Telemetry_Finish(enc);
+    st->bytes += len;
+    st->frames++;
+
+    // Round trip check, excluded from the timing
+    double tc = HostClock_Ns();
+    Telemetry_Record_t rec;
+    uint16_t off = 0;
+    uint32_t ts = 0;
+    float tol = (deadband ? deadband[0] : 0.0f) + 1e-4f;
+
+    memset(&rec, 0, sizeof(rec));
+    while (Telemetry_DecodeNext(frame, len, &off, &ts, &rec) == HAL_OK) {
+        if (rec.type != TELEMETRY_REC_SPS30_FLOAT)
+            continue;
+
+        while (st->next_check < upto && s[st->next_check].ts_ms < rec.timestamp)
+            st->next_check++;
+
+        const float *pm = (const float *)&s[st->next_check].pm;
+        if (s[st->next_check].ts_ms != rec.timestamp)
+            st->bad++;
+        for (int c = 0; c < TELEMETRY_PM_CHANNELS; c++) {
+            if (rec.value[c] - pm[c] > tol || pm[c] - rec.value[c] > tol)
+                st->bad++;
+        }
+    }
+    st->t_check += HostClock_Ns() - tc;
+
+    Telemetry_Reset(enc);
+}
+
+static int bench_batched(const char *name, const Sample_t *s, const float *deadband) {
+    Telemetry_Encoder_t enc;
+    BatchStats_t st;
+
+    memset(&st, 0, sizeof(st));
+    if (Telemetry_Init(&enc, frame, MTU, deadband) != HAL_OK)
+        return 1;
+
+    double t0 = HostClock_Ns();
+    uint64_t c0 = cycles();
+
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        while (Telemetry_AddSPS30(&enc, s[i].ts_ms, &s[i].pm) == HAL_BUSY)
+            flush_frame(&enc, s, i, deadband, &st);
+        while (Telemetry_AddLux(&enc, s[i].ts_ms, s[i].lux) == HAL_BUSY)
+            flush_frame(&enc, s, i, deadband, &st);
+    }
+    flush_frame(&enc, s, NUM_SAMPLES - 1, deadband, &st);
+
+    uint64_t cyc = cycles() - c0;
+    report(name, st.bytes, st.frames, HostClock_Ns() - t0 - st.t_check, cyc);
+    if (deadband)
+        printf("%-22s %u fields suppressed by deadband\n", "", enc.suppressed);
+    if (st.bad)
+        printf("%-22s decode MISMATCH (%d fields)\n", "", st.bad);
+
+    return st.bad != 0;
+}
+
+int main(void) {
+    Sample_t *s = malloc(sizeof(Sample_t) * NUM_SAMPLES);
+    float deadband[TELEMETRY_NUM_CHANNELS];
+    int failed = 0;
+
+    // Slowly drifting signal sampled at 1 Hz
+    srand(1);
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        float *pm = (float *)&s[i].pm;
+        s[i].ts_ms = 1000u * i + (rand() % 5);
+        for (int c = 0; c < TELEMETRY_PM_CHANNELS; c++)
+            pm[c] = 10.0f + c + (float)((i / 30) % 20) * 0.5f + (float)(rand() % 100) * 0.001f;
+        s[i].lux = (float)(300 + (i / 120) % 50);
+    }
+
+    for (int c = 0; c < TELEMETRY_NUM_CHANNELS; c++)
+        deadband[c] = 0.2f;
+
+    printf("%d samples (SPS30 float + lux), MTU %d\n", NUM_SAMPLES, MTU);
+    bench_naive(s);
+    failed |= bench_batched("batched", s, NULL);
+    failed |= bench_batched("batched + deadband", s, deadband);
+
+    free(s);
+    return failed;
+}
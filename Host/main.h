@@ -0,0 +1,58 @@
+/*
+ * main.h
+ *
+ *  Host-side stand-in for the CubeMX generated main.h, so the libraries
+ *  can be built and benchmarked on a PC.
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#ifndef HOST_MAIN_H_
+#define HOST_MAIN_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum
+{
+  HAL_OK       = 0x00U,
+  HAL_ERROR    = 0x01U,
+  HAL_BUSY     = 0x02U,
+  HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY      0xFFFFFFFFU
+
+#ifndef __weak
+#define __weak             __attribute__((weak))
+#endif
+
+// Single threaded host: interrupt masking is a no-op
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+
+typedef struct
+{
+  uint32_t ClockSpeed;
+} I2C_InitTypeDef;
+
+typedef struct
+{
+  I2C_InitTypeDef Init;
+} I2C_HandleTypeDef;
+
+
+// Implemented by SimI2C.c
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c);
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+void HAL_Delay(uint32_t Delay);
+
+uint32_t HAL_GetTick(void);
+
+
+#endif /* HOST_MAIN_H_ */
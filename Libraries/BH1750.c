@@ -8,6 +8,11 @@
 
 #include "BH1750.h"
 
+HAL_StatusTypeDef BH1750_BusInit(void)
+{
+    return I2CBus_RegisterDevice(BH1750_ADDR, BH1750_MAX_SCL_HZ);
+}
+
 HAL_StatusTypeDef BH1750_ResetSensor(void){
 
     uint8_t cmd;
@@ -15,14 +20,14 @@ HAL_StatusTypeDef BH1750_ResetSensor(void){
 
     // 1. Power On
     cmd = BH1750_POWER_ON;
-    ret = HAL_I2C_Master_Transmit(&hi2c1, BH1750_ADDR, &cmd, 1, HAL_MAX_DELAY);
+    ret = I2CBus_Transmit(BH1750_ADDR, &cmd, 1, HAL_MAX_DELAY);
     if(ret != HAL_OK) return ret;
 
     HAL_Delay(10);
 
     // 2. Reset
     cmd = BH1750_RESET;
-    ret = HAL_I2C_Master_Transmit(&hi2c1, BH1750_ADDR, &cmd, 1, HAL_MAX_DELAY);
+    ret = I2CBus_Transmit(BH1750_ADDR, &cmd, 1, HAL_MAX_DELAY);
 
     return ret;
 }
@@ -31,19 +36,19 @@ HAL_StatusTypeDef BH1750_ResetSensor(void){
 HAL_StatusTypeDef BH1750_PowerOn(void)
 {
     uint8_t cmd = BH1750_POWER_ON;  // 0x01
-    return HAL_I2C_Master_Transmit(&hi2c1, BH1750_ADDR, &cmd, 1, HAL_MAX_DELAY);
+    return I2CBus_Transmit(BH1750_ADDR, &cmd, 1, HAL_MAX_DELAY);
 }
 
 
 HAL_StatusTypeDef BH1750_PowerDown(void)
 {
     uint8_t cmd = BH1750_POWER_DOWN;
-    return HAL_I2C_Master_Transmit(&hi2c1, BH1750_ADDR, &cmd, 1, HAL_MAX_DELAY);
+    return I2CBus_Transmit(BH1750_ADDR, &cmd, 1, HAL_MAX_DELAY);
 }
 
 HAL_StatusTypeDef BH1750_SetMode(uint8_t mode)
 {
-    return HAL_I2C_Master_Transmit(&hi2c1, BH1750_ADDR, &mode, 1, HAL_MAX_DELAY);
+    return I2CBus_Transmit(BH1750_ADDR, &mode, 1, HAL_MAX_DELAY);
 }
 
 
@@ -52,7 +57,7 @@ HAL_StatusTypeDef BH1750_ReadRaw(uint16_t *raw)
     uint8_t data[2];
     HAL_StatusTypeDef ret;
 
-    ret = HAL_I2C_Master_Receive(&hi2c1, BH1750_ADDR, data, 2, HAL_MAX_DELAY);
+    ret = I2CBus_Receive(BH1750_ADDR, data, 2, HAL_MAX_DELAY);
     if(ret != HAL_OK)
     	return ret;
 
@@ -113,11 +118,11 @@ HAL_StatusTypeDef BH1750_SetMeasurementTime(uint8_t mtreg)
     uint8_t low  = 0x60 | (mtreg & 0x1F); // 011_MT[4,3,2,1,0]
 
     // send High byte
-    status = HAL_I2C_Master_Transmit(&hi2c1, BH1750_ADDR, &high, 1, HAL_MAX_DELAY);
+    status = I2CBus_Transmit(BH1750_ADDR, &high, 1, HAL_MAX_DELAY);
     if (status != HAL_OK) return status;
 
     // send Low byte
-    status = HAL_I2C_Master_Transmit(&hi2c1, BH1750_ADDR, &low, 1, HAL_MAX_DELAY);
+    status = I2CBus_Transmit(BH1750_ADDR, &low, 1, HAL_MAX_DELAY);
     return status;
 }
 
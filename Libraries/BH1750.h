@@ -13,7 +13,10 @@
 #include <string.h>
 #include <stdbool.h>
 
+#include "I2CBus.h"
+
 #define BH1750_ADDR      0x23 << 1   // ADDR = L
+#define BH1750_MAX_SCL_HZ   I2CBUS_FM_HZ    // Fast-mode capable
 
 // Power / Reset
 #define BH1750_POWER_DOWN   0x00
@@ -35,6 +38,8 @@
 extern I2C_HandleTypeDef hi2c1;
 
 
+HAL_StatusTypeDef BH1750_BusInit(void);
+
 HAL_StatusTypeDef BH1750_ResetSensor(void);
 
 HAL_StatusTypeDef BH1750_PowerOn(void);
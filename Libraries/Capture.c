@@ -0,0 +1,179 @@
+/*
+ * Capture.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#include "Capture.h"
+
+
+static uint8_t Capture_PayloadLen(uint8_t type) {
+    switch (type)
+    {
+        case CAPTURE_SPS30_FLOAT: return SPS30_MEASURED_FLOAT_LEN;
+        case CAPTURE_SPS30_U16:   return SPS30_MEASURED_U16_LEN;
+        case CAPTURE_BH1750:      return 2;
+        default:                  return 0;
+    }
+}
+
+// Reserve an entry; it only becomes visible once Capture_Commit runs
+static uint8_t *Capture_Reserve(Capture_Arena_t *arena, uint8_t type, uint32_t timestamp) {
+    uint32_t need = CAPTURE_ENTRY_HEADER_LEN + Capture_PayloadLen(type);
+    uint8_t *entry;
+
+    if (arena->used + need > arena->size) {
+        arena->dropped++;
+        return NULL;
+    }
+
+    entry = &arena->buf[arena->used];
+    memcpy(entry, &timestamp, sizeof(timestamp));
+    entry[4] = type;
+    entry[5] = 0;
+
+    return &entry[CAPTURE_ENTRY_HEADER_LEN];
+}
+
+static void Capture_Commit(Capture_Arena_t *arena, uint8_t type) {
+    arena->used += CAPTURE_ENTRY_HEADER_LEN + Capture_PayloadLen(type);
+    arena->count++;
+}
+
+/* CRC of one 2-byte word + CRC triplet, skipped when the whole entry was
+   validated clean. An entry with a bad word still has good ones: those are
+   checked individually so the answer does not depend on the background pass. */
+static bool Capture_WordOk(const Capture_View_t *view, const uint8_t *word) {
+    if ((*view->flags & (CAPTURE_FLAG_CHECKED | CAPTURE_FLAG_CRC_ERROR)) == CAPTURE_FLAG_CHECKED)
+    	return true;
+
+    return word[2] == SPS30_CalcCRC(word, 2);
+}
+
+
+void Capture_Init(Capture_Arena_t *arena, uint8_t *buf, uint32_t size) {
+    arena->buf = buf;
+    arena->size = size;
+    Capture_Reset(arena);
+}
+
+void Capture_Reset(Capture_Arena_t *arena) {
+    arena->used = 0;
+    arena->count = 0;
+    arena->validated = 0;
+    arena->dropped = 0;
+}
+
+HAL_StatusTypeDef Capture_SPS30(Capture_Arena_t *arena, bool isFloat, uint32_t timestamp) {
+    uint8_t type = isFloat ? CAPTURE_SPS30_FLOAT : CAPTURE_SPS30_U16;
+    uint8_t *payload = Capture_Reserve(arena, type, timestamp);
+    HAL_StatusTypeDef status;
+
+    if (payload == NULL)
+    	return HAL_BUSY;
+
+    status = SPS30_ReadMeasuredRaw(isFloat, payload);
+    if (status != HAL_OK)
+    	return status;
+
+    Capture_Commit(arena, type);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef Capture_BH1750(Capture_Arena_t *arena, uint32_t timestamp) {
+    uint8_t *payload = Capture_Reserve(arena, CAPTURE_BH1750, timestamp);
+    HAL_StatusTypeDef status;
+
+    if (payload == NULL)
+    	return HAL_BUSY;
+
+    status = I2CBus_Receive(BH1750_ADDR, payload, 2, HAL_MAX_DELAY);
+    if (status != HAL_OK)
+    	return status;
+
+    Capture_Commit(arena, CAPTURE_BH1750);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef Capture_Next(Capture_Arena_t *arena, uint32_t *offset, Capture_View_t *view) {
+    uint8_t *entry;
+
+    if (*offset >= arena->used)
+    	return HAL_BUSY;
+
+    entry = &arena->buf[*offset];
+    memcpy(&view->timestamp, entry, sizeof(view->timestamp));
+    view->type = entry[4];
+    view->flags = &entry[5];
+    view->payload = &entry[CAPTURE_ENTRY_HEADER_LEN];
+
+    *offset += CAPTURE_ENTRY_HEADER_LEN + Capture_PayloadLen(view->type);
+    return HAL_OK;
+}
+
+uint32_t Capture_Validate(Capture_Arena_t *arena, uint32_t max_entries) {
+    Capture_View_t view;
+    uint32_t n = 0;
+
+    while (n < max_entries && Capture_Next(arena, &arena->validated, &view) == HAL_OK) {
+        uint8_t flags = CAPTURE_FLAG_CHECKED;
+
+        // BH1750 counts carry no CRC
+        if (view.type != CAPTURE_BH1750) {
+            uint8_t len = Capture_PayloadLen(view.type);
+            for (uint8_t i = 0; i < len; i += 3) {
+                if (view.payload[i + 2] != SPS30_CalcCRC(&view.payload[i], 2)) {
+                    flags |= CAPTURE_FLAG_CRC_ERROR;
+                    break;
+                }
+            }
+        }
+
+        *view.flags = flags;
+        n++;
+    }
+
+    return n;
+}
+
+HAL_StatusTypeDef Capture_ViewSPS30Float(const Capture_View_t *view, uint8_t field, float *value) {
+    const uint8_t *p;
+
+    if (view->type != CAPTURE_SPS30_FLOAT || field >= 10)
+    	return HAL_ERROR;
+
+    p = &view->payload[field * 6];
+    if (!Capture_WordOk(view, &p[0]) || !Capture_WordOk(view, &p[3]))
+    	return HAL_ERROR;
+
+    uint32_t temp = ((uint32_t)p[0] << 24) |
+                    ((uint32_t)p[1] << 16) |
+                    ((uint32_t)p[3] << 8) |
+                    ((uint32_t)p[4]);
+    memcpy(value, &temp, sizeof(float));
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef Capture_ViewSPS30U16(const Capture_View_t *view, uint8_t field, uint16_t *value) {
+    const uint8_t *p;
+
+    if (view->type != CAPTURE_SPS30_U16 || field >= 10)
+    	return HAL_ERROR;
+
+    p = &view->payload[field * 3];
+    if (!Capture_WordOk(view, p))
+    	return HAL_ERROR;
+
+    *value = ((uint16_t)p[0] << 8) | p[1];
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef Capture_ViewLux(const Capture_View_t *view, float *lux) {
+    if (view->type != CAPTURE_BH1750)
+    	return HAL_ERROR;
+
+    *lux = BH1750_CalcLux(((uint16_t)view->payload[0] << 8) | view->payload[1]);
+    return HAL_OK;
+}
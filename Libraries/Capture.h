@@ -0,0 +1,107 @@
+/*
+ * Capture.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#ifndef INC_CAPTURE_H_
+#define INC_CAPTURE_H_
+
+#include "main.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "SPS30.h"
+#include "BH1750.h"
+
+/* Burst capture: raw wire bytes are received straight into a preallocated
+   arena, with no CRC check and no conversion. CRCs and values are only
+   computed when a field is read through a view, or by Capture_Validate
+   running as a background pass.
+
+   Entry layout: [timestamp:4][type:1][flags:1][payload] where the payload is
+   the SPS30 frame (60 or 30 bytes) or the two BH1750 count bytes. */
+
+#define CAPTURE_ENTRY_HEADER_LEN    6
+
+// Entry types
+#define CAPTURE_SPS30_FLOAT         0x01
+#define CAPTURE_SPS30_U16           0x02
+#define CAPTURE_BH1750              0x03
+
+// Entry flags, set by Capture_Validate
+#define CAPTURE_FLAG_CHECKED        0x01
+#define CAPTURE_FLAG_CRC_ERROR      0x02    // At least one word of the entry is bad
+
+
+typedef struct {
+    uint8_t *buf;
+    uint32_t size;
+    uint32_t used;
+    uint32_t count;
+    uint32_t validated;     // Offset of the first entry Capture_Validate has not seen
+    uint32_t dropped;       // Captures refused because the arena was full
+} Capture_Arena_t;
+
+// Read-only window on one captured entry
+typedef struct {
+    uint32_t timestamp;
+    uint8_t type;
+    uint8_t *flags;
+    const uint8_t *payload;
+} Capture_View_t;
+
+
+void Capture_Init(Capture_Arena_t *arena, uint8_t *buf, uint32_t size);
+
+
+void Capture_Reset(Capture_Arena_t *arena);
+
+
+/**
+ * @brief Read one SPS30 measured-values frame into the arena, undecoded
+ * @return HAL_BUSY when the arena is full, otherwise the bus status
+ */
+HAL_StatusTypeDef Capture_SPS30(Capture_Arena_t *arena, bool isFloat, uint32_t timestamp);
+
+
+/**
+ * @brief Read the BH1750 count into the arena (sensor must already be measuring)
+ * @return HAL_BUSY when the arena is full, otherwise the bus status
+ */
+HAL_StatusTypeDef Capture_BH1750(Capture_Arena_t *arena, uint32_t timestamp);
+
+
+/**
+ * @brief Step through the captured entries
+ * @param offset 0 to start, then the value left by the previous call
+ * @return HAL_OK with view filled, HAL_BUSY after the last entry
+ */
+HAL_StatusTypeDef Capture_Next(Capture_Arena_t *arena, uint32_t *offset, Capture_View_t *view);
+
+
+/**
+ * @brief Check CRCs of up to max_entries entries not yet validated
+ * @return Number of entries validated by this call
+ */
+uint32_t Capture_Validate(Capture_Arena_t *arena, uint32_t max_entries);
+
+
+/**
+ * @brief Decode a single SPS30 field (index in SPS30_Measurement_Float_t / _U16_t order)
+ *        Only that field's CRC is checked, and not at all once Capture_Validate
+ *        found the whole entry clean.
+ * @return HAL_ERROR on CRC mismatch or wrong entry type
+ */
+HAL_StatusTypeDef Capture_ViewSPS30Float(const Capture_View_t *view, uint8_t field, float *value);
+
+
+HAL_StatusTypeDef Capture_ViewSPS30U16(const Capture_View_t *view, uint8_t field, uint16_t *value);
+
+
+HAL_StatusTypeDef Capture_ViewLux(const Capture_View_t *view, float *lux);
+
+
+#endif /* INC_CAPTURE_H_ */
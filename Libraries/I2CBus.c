@@ -0,0 +1,165 @@
+/*
+ * I2CBus.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#include "I2CBus.h"
+
+
+static I2CBus_Device_t devices[I2CBUS_MAX_DEVICES];
+static uint8_t device_count = 0;
+
+static I2CBus_Txn_t *queue[I2CBUS_QUEUE_LEN];
+static uint8_t queue_len = 0;
+
+static uint32_t current_hz = I2CBUS_INITIAL_SCL_HZ;
+static I2CBus_Stats_t stats;
+
+
+static uint32_t I2CBus_RateOf(uint16_t addr) {
+    for (uint8_t i = 0; i < device_count; i++) {
+        if (devices[i].addr == addr)
+        	return devices[i].max_scl_hz;
+    }
+
+    return I2CBUS_DEFAULT_SCL_HZ;
+}
+
+static HAL_StatusTypeDef I2CBus_Select(uint32_t scl_hz) {
+    HAL_StatusTypeDef status;
+
+    if (scl_hz == current_hz)
+    	return HAL_OK;
+
+    // On failure keep the last rate that was programmed successfully; the next transaction retries.
+    // A device is always safe below its maximum, so only a rate that is too fast is an error.
+    status = I2CBus_ApplyClock(&hi2c1, scl_hz);
+    if (status != HAL_OK)
+    	return (current_hz < scl_hz) ? HAL_OK : status;
+
+    current_hz = scl_hz;
+    stats.reconfigs++;
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef I2CBus_Run(I2CBus_Txn_t *txn) {
+    stats.transactions++;
+
+    if (txn->dir == I2CBUS_WRITE)
+    	return HAL_I2C_Master_Transmit(&hi2c1, txn->addr, txn->data, txn->size, txn->timeout);
+
+    return HAL_I2C_Master_Receive(&hi2c1, txn->addr, txn->data, txn->size, txn->timeout);
+}
+
+
+__weak HAL_StatusTypeDef I2CBus_ApplyClock(I2C_HandleTypeDef *hi2c, uint32_t scl_hz) {
+#if defined(I2C_TIMINGR_PRESC)
+    // Init.Timing has no closed form in scl_hz: override with the CubeMX values per rate
+    (void)hi2c;
+    (void)scl_hz;
+    return HAL_ERROR;
+#else
+    hi2c->Init.ClockSpeed = scl_hz;
+    return HAL_I2C_Init(hi2c);
+#endif
+}
+
+void I2CBus_Init(void) {
+    device_count = 0;
+    queue_len = 0;
+    current_hz = I2CBUS_INITIAL_SCL_HZ;
+    memset(&stats, 0, sizeof(stats));
+}
+
+HAL_StatusTypeDef I2CBus_RegisterDevice(uint16_t addr, uint32_t max_scl_hz) {
+    for (uint8_t i = 0; i < device_count; i++) {
+        if (devices[i].addr == addr) {
+            devices[i].max_scl_hz = max_scl_hz;
+            return HAL_OK;
+        }
+    }
+
+    if (device_count == I2CBUS_MAX_DEVICES)
+    	return HAL_ERROR;
+
+    devices[device_count].addr = addr;
+    devices[device_count].max_scl_hz = max_scl_hz;
+    device_count++;
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef I2CBus_Transmit(uint16_t addr, uint8_t *data, uint16_t size, uint32_t timeout) {
+    I2CBus_Txn_t txn = { addr, I2CBUS_WRITE, data, size, timeout, HAL_OK };
+    HAL_StatusTypeDef status;
+
+    status = I2CBus_Select(I2CBus_RateOf(addr));
+    if (status != HAL_OK)
+    	return status;
+
+    return I2CBus_Run(&txn);
+}
+
+HAL_StatusTypeDef I2CBus_Receive(uint16_t addr, uint8_t *data, uint16_t size, uint32_t timeout) {
+    I2CBus_Txn_t txn = { addr, I2CBUS_READ, data, size, timeout, HAL_OK };
+    HAL_StatusTypeDef status;
+
+    status = I2CBus_Select(I2CBus_RateOf(addr));
+    if (status != HAL_OK)
+    	return status;
+
+    return I2CBus_Run(&txn);
+}
+
+HAL_StatusTypeDef I2CBus_Submit(I2CBus_Txn_t *txn) {
+    if (queue_len == I2CBUS_QUEUE_LEN)
+    	return HAL_BUSY;
+
+    txn->status = HAL_BUSY;
+    queue[queue_len++] = txn;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef I2CBus_Flush(void) {
+    HAL_StatusTypeDef result = HAL_OK;
+    uint32_t rate[I2CBUS_QUEUE_LEN];
+    bool done[I2CBUS_QUEUE_LEN] = { false };
+    uint8_t remaining = queue_len;
+
+    for (uint8_t i = 0; i < queue_len; i++)
+        rate[i] = I2CBus_RateOf(queue[i]->addr);
+
+    // Drain the group at the current rate first, then the rate of the oldest pending transaction
+    uint32_t group_hz = current_hz;
+    while (remaining > 0) {
+        HAL_StatusTypeDef status = I2CBus_Select(group_hz);
+
+        for (uint8_t i = 0; i < queue_len; i++) {
+            if (done[i] || rate[i] != group_hz)
+            	continue;
+
+            queue[i]->status = (status == HAL_OK) ? I2CBus_Run(queue[i]) : status;
+            if (queue[i]->status != HAL_OK && result == HAL_OK)
+            	result = queue[i]->status;
+
+            done[i] = true;
+            remaining--;
+        }
+
+        for (uint8_t i = 0; i < queue_len; i++) {
+            if (!done[i]) {
+                group_hz = rate[i];
+                break;
+            }
+        }
+    }
+
+    queue_len = 0;
+    return result;
+}
+
+void I2CBus_GetStats(I2CBus_Stats_t *out) {
+    *out = stats;
+}
@@ -0,0 +1,128 @@
+/*
+ * I2CBus.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#ifndef INC_I2CBUS_H_
+#define INC_I2CBUS_H_
+
+#include "main.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+/* Shared access to hi2c1 with a per-device maximum SCL rate.
+   The peripheral is only re-initialised when a transaction targets a device
+   whose rate differs from the one currently programmed. Queued transactions
+   (I2CBus_Submit / I2CBus_Flush) are grouped by rate so a mixed workload pays
+   for as few re-initialisations as possible. Devices that were never
+   registered run at I2CBUS_DEFAULT_SCL_HZ.
+
+   The programmed rate is tracked here only; the HAL init struct is touched
+   by I2CBus_ApplyClock alone. I2CBUS_INITIAL_SCL_HZ must match the rate
+   MX_I2C1_Init configures. */
+
+extern I2C_HandleTypeDef hi2c1;
+
+#define I2CBUS_SM_HZ            100000u     // Standard-mode
+#define I2CBUS_FM_HZ            400000u     // Fast-mode
+
+#ifndef I2CBUS_INITIAL_SCL_HZ
+#define I2CBUS_INITIAL_SCL_HZ   I2CBUS_SM_HZ
+#endif
+
+#ifndef I2CBUS_DEFAULT_SCL_HZ
+#define I2CBUS_DEFAULT_SCL_HZ   I2CBUS_INITIAL_SCL_HZ
+#endif
+
+#ifndef I2CBUS_MAX_DEVICES
+#define I2CBUS_MAX_DEVICES      8
+#endif
+
+#ifndef I2CBUS_QUEUE_LEN
+#define I2CBUS_QUEUE_LEN        32
+#endif
+
+
+typedef enum
+{
+  I2CBUS_WRITE = 0x00U,
+  I2CBUS_READ  = 0x01U,
+
+} I2CBus_Dir_t;
+
+typedef struct {
+    uint16_t addr;          // 8-bit (shifted) address, as passed to HAL
+    uint32_t max_scl_hz;
+} I2CBus_Device_t;
+
+// One queued transaction, status is valid after I2CBus_Flush
+typedef struct {
+    uint16_t addr;
+    I2CBus_Dir_t dir;
+    uint8_t *data;
+    uint16_t size;
+    uint32_t timeout;
+    HAL_StatusTypeDef status;
+} I2CBus_Txn_t;
+
+typedef struct {
+    uint32_t transactions;
+    uint32_t reconfigs;
+} I2CBus_Stats_t;
+
+
+/**
+ * @brief Forget registered devices, queued transactions and statistics; the
+ *        bus is taken to run at I2CBUS_INITIAL_SCL_HZ (call after MX_I2C1_Init)
+ */
+void I2CBus_Init(void);
+
+
+/**
+ * @brief Record the fastest SCL rate a device supports
+ * @param addr 8-bit (shifted) device address
+ * @param max_scl_hz Maximum SCL frequency in Hz
+ * @return HAL_ERROR when the device table is full
+ */
+HAL_StatusTypeDef I2CBus_RegisterDevice(uint16_t addr, uint32_t max_scl_hz);
+
+
+HAL_StatusTypeDef I2CBus_Transmit(uint16_t addr, uint8_t *data, uint16_t size, uint32_t timeout);
+
+
+HAL_StatusTypeDef I2CBus_Receive(uint16_t addr, uint8_t *data, uint16_t size, uint32_t timeout);
+
+
+/**
+ * @brief Queue a transaction for the next I2CBus_Flush
+ * @return HAL_BUSY when the queue is full
+ */
+HAL_StatusTypeDef I2CBus_Submit(I2CBus_Txn_t *txn);
+
+
+/**
+ * @brief Run all queued transactions, grouped by SCL rate starting with the current one.
+ *        Transactions to the same device keep their submission order.
+ * @return HAL_OK when every transaction succeeded, otherwise the first failing status
+ */
+HAL_StatusTypeDef I2CBus_Flush(void);
+
+
+/**
+ * @brief Program a new SCL rate into the peripheral. The default implementation
+ *        sets Init.ClockSpeed and re-runs HAL_I2C_Init (F1/F2/F4/L1 HAL). On parts
+ *        with a TIMINGR register (F0/F3/F7/L0/L4/G0/G4/H7) the default returns
+ *        HAL_ERROR: override it to set Init.Timing to the CubeMX value for each
+ *        rate in use. When switching fails, devices faster than the current
+ *        rate keep running at it; only devices slower than the current rate fail.
+ */
+HAL_StatusTypeDef I2CBus_ApplyClock(I2C_HandleTypeDef *hi2c, uint32_t scl_hz);
+
+
+void I2CBus_GetStats(I2CBus_Stats_t *stats);
+
+
+#endif /* INC_I2CBUS_H_ */
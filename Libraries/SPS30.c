@@ -10,7 +10,7 @@
 
 
 
-uint8_t SPS30_CalcCRC(uint8_t *data, uint16_t length) {
+uint8_t SPS30_CalcCRC(const uint8_t *data, uint16_t length) {
     uint8_t crc = 0xFF;
 
     for(uint16_t i = 0; i < length; i++) {
@@ -27,6 +27,10 @@ uint8_t SPS30_CalcCRC(uint8_t *data, uint16_t length) {
     return crc;
 }
 
+HAL_StatusTypeDef SPS30_BusInit(void) {
+    return I2CBus_RegisterDevice(SPS30_I2C_ADDR, SPS30_MAX_SCL_HZ);
+}
+
 HAL_StatusTypeDef SPS30_DeviceReset(void){
 
     uint8_t buf[2];
@@ -35,7 +39,7 @@ HAL_StatusTypeDef SPS30_DeviceReset(void){
     buf[0] = (SPS30_CMD_RESET >> 8) & 0xFF;  // MSB
     buf[1] = SPS30_CMD_RESET & 0xFF;         // LSB
 
-    if(HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, buf, 2, I2C_TIMEOUT) != HAL_OK) {
+    if(I2CBus_Transmit(SPS30_I2C_ADDR, buf, 2, I2C_TIMEOUT) != HAL_OK) {
         return HAL_ERROR;
     }
 
@@ -49,7 +53,7 @@ HAL_StatusTypeDef SPS30_StartFanCleaning(void) {
     buf[0] = (SPS30_CMD_START_FAN_CLEANING >> 8) & 0xFF;  // MSB
     buf[1] = SPS30_CMD_START_FAN_CLEANING & 0xFF;         // LSB
 
-    if(HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, buf, 2, I2C_TIMEOUT) != HAL_OK) {
+    if(I2CBus_Transmit(SPS30_I2C_ADDR, buf, 2, I2C_TIMEOUT) != HAL_OK) {
         return HAL_ERROR;
     }
 
@@ -66,13 +70,13 @@ HAL_StatusTypeDef SPS30_WakeUp(void) {
     buf[1] = SPS30_CMD_WAKEUP & 0xFF;         // LSB
 
     // First wake-up command: activates the I2C interface
-    if(HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, buf, 2, I2C_TIMEOUT) != HAL_OK) {
+    if(I2CBus_Transmit(SPS30_I2C_ADDR, buf, 2, I2C_TIMEOUT) != HAL_OK) {
         return HAL_ERROR;
     }
     // Short delay before sending the second command (optional)
     HAL_Delay(5);
     // Second wake-up command: sets sensor to Idle Mode
-    if(HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, buf, 2, I2C_TIMEOUT) != HAL_OK) {
+    if(I2CBus_Transmit(SPS30_I2C_ADDR, buf, 2, I2C_TIMEOUT) != HAL_OK) {
         return HAL_ERROR;
     }
 
@@ -87,7 +91,7 @@ HAL_StatusTypeDef SPS30_Sleep(void) {
     buf[1] = SPS30_CMD_SLEEP & 0xFF;         // LSB
 
     // Send Sleep command via I2C
-    if(HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, buf, 2, I2C_TIMEOUT) != HAL_OK) {
+    if(I2CBus_Transmit(SPS30_I2C_ADDR, buf, 2, I2C_TIMEOUT) != HAL_OK) {
         return HAL_ERROR;  // Return error if transmission fails
     }
 
@@ -102,7 +106,7 @@ HAL_StatusTypeDef SPS30_StopMeasurement(void){
     buf[1] = SPS30_CMD_STOP_MEASUREMENT & 0xFF;         // LSB
 
     // Send Stop Measurement command via I2C
-    if(HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, buf, 2, I2C_TIMEOUT) != HAL_OK) {
+    if(I2CBus_Transmit(SPS30_I2C_ADDR, buf, 2, I2C_TIMEOUT) != HAL_OK) {
         return HAL_ERROR;  // Return error if transmission fails
     }
 
@@ -124,7 +128,7 @@ HAL_StatusTypeDef SPS30_StartMeasurement(uint8_t format) {
     buf[4] = SPS30_CalcCRC(&buf[2], 2);
 
     // Send command + data to SPS30
-    if (HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, buf, 5, I2C_TIMEOUT) != HAL_OK) {
+    if (I2CBus_Transmit(SPS30_I2C_ADDR, buf, 5, I2C_TIMEOUT) != HAL_OK) {
         return HAL_ERROR; // Transmission failed
     }
 
@@ -142,12 +146,12 @@ HAL_StatusTypeDef SPS30_ReadDataReady(uint8_t *ready) {
 
 
     // Send Set Pointer command
-    if (HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, cmd, 2, I2C_TIMEOUT) != HAL_OK) {
+    if (I2CBus_Transmit(SPS30_I2C_ADDR, cmd, 2, I2C_TIMEOUT) != HAL_OK) {
         return HAL_ERROR;
     }
 
     // Read 3 bytes from sensor
-    if (HAL_I2C_Master_Receive(&hi2c1, SPS30_I2C_ADDR, rxBuf, 3, I2C_TIMEOUT) != HAL_OK) {
+    if (I2CBus_Receive(SPS30_I2C_ADDR, rxBuf, 3, I2C_TIMEOUT) != HAL_OK) {
         return HAL_ERROR;
     }
 
@@ -164,9 +168,9 @@ HAL_StatusTypeDef SPS30_ReadDataReady(uint8_t *ready) {
 
 
 
-HAL_StatusTypeDef SPS30_ReadMeasuredValues(bool isFloat, SPS30_Measurement_Float_t *float_data, SPS30_Measurement_U16_t *u16_data) {
+HAL_StatusTypeDef SPS30_ReadMeasuredRaw(bool isFloat, uint8_t *rx_buf) {
     HAL_StatusTypeDef status;
-    uint8_t cmd[2] = {'/0'}; // Pointer address 0x0300
+    uint8_t cmd[2] = {'\0'}; // Pointer address 0x0300
 
 
     cmd[0] = (SPS30_CMD_READ_MEASURED_VALUES >> 8) & 0xFF;  // MSB
@@ -174,16 +178,18 @@ HAL_StatusTypeDef SPS30_ReadMeasuredValues(bool isFloat, SPS30_Measurement_Float
 
 
     // Send pointer command to sensor
-    status = HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, cmd, 2, HAL_MAX_DELAY);
+    status = I2CBus_Transmit(SPS30_I2C_ADDR, cmd, 2, HAL_MAX_DELAY);
     if (status != HAL_OK)
     	return status;
 
-    if (isFloat) {
-        uint8_t rx_buf[60]; // 10 float values * 4 bytes + 2 CRC each
-        status = HAL_I2C_Master_Receive(&hi2c1, SPS30_I2C_ADDR, rx_buf, sizeof(rx_buf), HAL_MAX_DELAY);
-        if (status != HAL_OK)
-        	return status;
+    // Wire frame as received: no CRC check, no conversion
+    return I2CBus_Receive(SPS30_I2C_ADDR, rx_buf,
+                          isFloat ? SPS30_MEASURED_FLOAT_LEN : SPS30_MEASURED_U16_LEN, HAL_MAX_DELAY);
+}
 
+
+HAL_StatusTypeDef SPS30_DecodeMeasuredValues(bool isFloat, const uint8_t *rx_buf, SPS30_Measurement_Float_t *float_data, SPS30_Measurement_U16_t *u16_data) {
+    if (isFloat) {
         // Convert received bytes into floats
         for (int i = 0; i < 10; i++) {
             // Check CRC for first 2 bytes
@@ -200,11 +206,6 @@ HAL_StatusTypeDef SPS30_ReadMeasuredValues(bool isFloat, SPS30_Measurement_Float
             memcpy(&((float*)float_data)[i], &temp, sizeof(float));
         }
     } else {
-        uint8_t rx_buf[30]; // 10 uint16 values * 2 bytes + 1 CRC each
-        status = HAL_I2C_Master_Receive(&hi2c1, SPS30_I2C_ADDR, rx_buf, sizeof(rx_buf), HAL_MAX_DELAY);
-        if (status != HAL_OK)
-        	return status;
-
         // Convert received bytes into uint16
         for (int i = 0; i < 10; i++) {
             // Check CRC
@@ -219,6 +220,18 @@ HAL_StatusTypeDef SPS30_ReadMeasuredValues(bool isFloat, SPS30_Measurement_Float
 }
 
 
+HAL_StatusTypeDef SPS30_ReadMeasuredValues(bool isFloat, SPS30_Measurement_Float_t *float_data, SPS30_Measurement_U16_t *u16_data) {
+    HAL_StatusTypeDef status;
+    uint8_t rx_buf[SPS30_MEASURED_FLOAT_LEN]; // 10 values * (4 bytes + 2 CRC) or (2 bytes + 1 CRC)
+
+    status = SPS30_ReadMeasuredRaw(isFloat, rx_buf);
+    if (status != HAL_OK)
+    	return status;
+
+    return SPS30_DecodeMeasuredValues(isFloat, rx_buf, float_data, u16_data);
+}
+
+
 
 
 
@@ -251,12 +264,12 @@ HAL_StatusTypeDef SPS30_WriteAutoCleaningInterval(uint32_t interval) {
     tx_buf[5] = SPS30_CalcCRC(&data[2], 2);
 
     // Send pointer first
-    status = HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, cmd, 2, HAL_MAX_DELAY);
+    status = I2CBus_Transmit(SPS30_I2C_ADDR, cmd, 2, HAL_MAX_DELAY);
     if (status != HAL_OK)
     	return status;
 
     // Send data
-    status = HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, tx_buf, 6, HAL_MAX_DELAY);
+    status = I2CBus_Transmit(SPS30_I2C_ADDR, tx_buf, 6, HAL_MAX_DELAY);
     return status;
 }
 
@@ -271,11 +284,11 @@ HAL_StatusTypeDef SPS30_ReadAutoCleaningInterval(uint32_t *interval) {
     cmd[1] = SPS30_CMD_AUTO_CLEANING_INTERVAL & 0xFF;         // LSB
 
     // Send pointer
-    status = HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, cmd, 2, HAL_MAX_DELAY);
+    status = I2CBus_Transmit(SPS30_I2C_ADDR, cmd, 2, HAL_MAX_DELAY);
     if (status != HAL_OK) return status;
 
     // Read 6 bytes (two words + CRC for each)
-    status = HAL_I2C_Master_Receive(&hi2c1, SPS30_I2C_ADDR, rx_buf, 6, HAL_MAX_DELAY);
+    status = I2CBus_Receive(SPS30_I2C_ADDR, rx_buf, 6, HAL_MAX_DELAY);
     if (status != HAL_OK) return status;
 
     // Check CRC for first two bytes
@@ -297,7 +310,7 @@ HAL_StatusTypeDef SPS30_ReadDeviceInfo(uint16_t pointer, char *output, uint8_t m
     uint8_t index = 0;
 
     // Send pointer command
-    status = HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, cmd, 2, HAL_MAX_DELAY);
+    status = I2CBus_Transmit(SPS30_I2C_ADDR, cmd, 2, HAL_MAX_DELAY);
     if (status != HAL_OK) return status;
 
     // Determine expected length (for serial number max 48 bytes)
@@ -306,7 +319,7 @@ HAL_StatusTypeDef SPS30_ReadDeviceInfo(uint16_t pointer, char *output, uint8_t m
     	expected_len = sizeof(rx_buf);
 
     // Read data
-    status = HAL_I2C_Master_Receive(&hi2c1, SPS30_I2C_ADDR, rx_buf, expected_len, HAL_MAX_DELAY);
+    status = I2CBus_Receive(SPS30_I2C_ADDR, rx_buf, expected_len, HAL_MAX_DELAY);
     if (status != HAL_OK)
     	return status;
 
@@ -350,11 +363,11 @@ HAL_StatusTypeDef SPS30_ReadFirmwareVersion(SPS30_FirmwareVersion_t *fw_version)
     cmd[1] = SPS30_CMD_READ_VERSION & 0xFF;         // LSB
 
     // Send pointer command
-    status = HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, cmd, 2, HAL_MAX_DELAY);
+    status = I2CBus_Transmit(SPS30_I2C_ADDR, cmd, 2, HAL_MAX_DELAY);
     if (status != HAL_OK) return status;
 
     // Read 3 bytes (2 data + CRC)
-    status = HAL_I2C_Master_Receive(&hi2c1, SPS30_I2C_ADDR, rx_buf, 3, HAL_MAX_DELAY);
+    status = I2CBus_Receive(SPS30_I2C_ADDR, rx_buf, 3, HAL_MAX_DELAY);
     if (status != HAL_OK) return status;
 
     // Check CRC
@@ -377,12 +390,12 @@ HAL_StatusTypeDef SPS30_ReadDeviceStatus(uint32_t *device_status) {
     cmd[1] = SPS30_CMD_READ_DEVICE_STATUS & 0xFF;         // LSB
 
     // Send the pointer command to SPS30
-    status = HAL_I2C_Master_Transmit(&hi2c1, SPS30_I2C_ADDR, cmd, 2, HAL_MAX_DELAY);
+    status = I2CBus_Transmit(SPS30_I2C_ADDR, cmd, 2, HAL_MAX_DELAY);
     if (status != HAL_OK)
     	return status;
 
     // Read 6 bytes (MSB 2 bytes + CRC + LSB 2 bytes + CRC)
-    status = HAL_I2C_Master_Receive(&hi2c1, SPS30_I2C_ADDR, rx_buf, 6, HAL_MAX_DELAY);
+    status = I2CBus_Receive(SPS30_I2C_ADDR, rx_buf, 6, HAL_MAX_DELAY);
     if (status != HAL_OK)
     	return status;
 
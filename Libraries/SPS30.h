@@ -14,10 +14,13 @@
 #include <string.h>
 #include <stdbool.h>
 
+#include "I2CBus.h"
+
 extern I2C_HandleTypeDef hi2c1;
 
 #define SPS30_I2C_ADDR		(0x69 << 1)
 #define I2C_TIMEOUT		1000
+#define SPS30_MAX_SCL_HZ	I2CBUS_SM_HZ	// Standard-mode only
 
 
 
@@ -42,6 +45,8 @@ extern I2C_HandleTypeDef hi2c1;
    Reads the latest measurement values and resets the Data-Ready Flag.
    Data format depends on output format: float (60 bytes) or integer (30 bytes) */
 #define SPS30_CMD_READ_MEASURED_VALUES    0x0300  // Set Pointer & Read Data, FW v1.0
+#define SPS30_MEASURED_FLOAT_LEN          60      // 10 values * (4 bytes + 2 CRC)
+#define SPS30_MEASURED_U16_LEN            30      // 10 values * (2 bytes + 1 CRC)
 
 /* Sleep
    Puts the sensor into Sleep-Mode to minimize power consumption.
@@ -144,7 +149,10 @@ typedef struct {
  * @param length Number of bytes in the array
  * @return CRC8 value
  */
-uint8_t SPS30_CalcCRC(uint8_t *data, uint16_t length);
+uint8_t SPS30_CalcCRC(const uint8_t *data, uint16_t length);
+
+
+HAL_StatusTypeDef SPS30_BusInit(void);
 
 
 HAL_StatusTypeDef SPS30_DeviceReset(void);
@@ -165,6 +173,28 @@ HAL_StatusTypeDef SPS30_StopMeasurement(void);
 HAL_StatusTypeDef SPS30_StartMeasurement(uint8_t format);
 
 
+HAL_StatusTypeDef SPS30_ReadDataReady(uint8_t *ready);
+
+
+HAL_StatusTypeDef SPS30_ReadMeasuredValues(bool isFloat, SPS30_Measurement_Float_t *float_data, SPS30_Measurement_U16_t *u16_data);
+
+
+/**
+ * @brief Read the measured-values frame exactly as it arrives on the wire
+ * @param isFloat true for the float format (60 bytes), false for uint16 (30 bytes)
+ * @param rx_buf Output, SPS30_MEASURED_FLOAT_LEN or SPS30_MEASURED_U16_LEN bytes
+ * @return HAL_OK on success; CRCs are not checked
+ */
+HAL_StatusTypeDef SPS30_ReadMeasuredRaw(bool isFloat, uint8_t *rx_buf);
+
+
+/**
+ * @brief Verify the CRCs of a measured-values frame and convert it
+ * @return HAL_ERROR on CRC mismatch
+ */
+HAL_StatusTypeDef SPS30_DecodeMeasuredValues(bool isFloat, const uint8_t *rx_buf, SPS30_Measurement_Float_t *float_data, SPS30_Measurement_U16_t *u16_data);
+
+
 HAL_StatusTypeDef SPS30_WriteAutoCleaningInterval(uint32_t interval);
 
 
@@ -180,6 +210,12 @@ HAL_StatusTypeDef SPS30_GetProductType(char *product_type);
 HAL_StatusTypeDef SPS30_GetSerialNumber(char *serial_number);
 
 
+HAL_StatusTypeDef SPS30_ReadFirmwareVersion(SPS30_FirmwareVersion_t *fw_version);
+
+
+HAL_StatusTypeDef SPS30_ReadDeviceStatus(uint32_t *device_status);
+
+
 
 
 
@@ -0,0 +1,274 @@
+/*
+ * Sampler.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#include "Sampler.h"
+#include <math.h>
+
+
+static Sampler_Device_t devices[SAMPLER_MAX_DEVICES];
+static uint8_t device_count = 0;
+static uint32_t tick_period_us = 1000;
+static volatile uint32_t ticks = 0;
+
+static uint64_t bh1750_last_us = 0;     // Last BH1750 read on the timeline
+static bool bh1750_read_once = false;
+
+
+static Sampler_Sample_t *Sampler_HistoryAt(Sampler_Device_t *d, uint8_t age) {
+    return &d->history[(d->head + SAMPLER_HISTORY_LEN - age) % SAMPLER_HISTORY_LEN];
+}
+
+static void Sampler_Record(Sampler_Device_t *d, uint32_t trigger_tick, uint64_t now_us, const float *values) {
+    uint64_t scheduled_us = (uint64_t)trigger_tick * tick_period_us;
+    uint32_t latency = (now_us > scheduled_us) ? (uint32_t)(now_us - scheduled_us) : 0;
+
+    // Interval against the nominal spacing of the two triggers (overruns skip one)
+    if (d->count > 0) {
+        uint64_t prev_us = Sampler_HistoryAt(d, 0)->timestamp_us;
+        int64_t nominal = (int64_t)(trigger_tick - d->last_tick) * tick_period_us;
+        int64_t dev = (int64_t)(now_us - prev_us) - nominal;
+        uint32_t abs_dev = (uint32_t)(dev < 0 ? -dev : dev);
+
+        d->interval_dev2_sum += (uint64_t)abs_dev * abs_dev;
+        if (abs_dev > d->interval_dev_max) d->interval_dev_max = abs_dev;
+        d->n_interval++;
+    }
+
+    d->latency_sum += latency;
+    if (d->n_latency == 0 || latency < d->latency_min) d->latency_min = latency;
+    if (latency > d->latency_max) d->latency_max = latency;
+    d->n_latency++;
+
+    d->head = (d->head + 1) % SAMPLER_HISTORY_LEN;
+    if (d->count < SAMPLER_HISTORY_LEN) d->count++;
+
+    Sampler_Sample_t *s = &d->history[d->head];
+    s->timestamp_us = now_us;
+    memcpy(s->value, values, d->n_values * sizeof(float));
+
+    d->last_tick = trigger_tick;
+}
+
+
+__weak uint32_t Sampler_TimerCounterUs(bool *update_pending) {
+    *update_pending = false;
+    return 0;
+}
+
+void Sampler_Init(uint32_t tick_us) {
+    memset(devices, 0, sizeof(devices));
+    device_count = 0;
+    tick_period_us = tick_us;
+    ticks = 0;
+    bh1750_read_once = false;
+}
+
+HAL_StatusTypeDef Sampler_Register(const char *name, uint32_t period_ticks, Sampler_AcquireFn acquire,
+                                   void *ctx, uint8_t n_values, uint8_t *id) {
+    Sampler_Device_t *d;
+
+    if (device_count == SAMPLER_MAX_DEVICES || period_ticks == 0 || acquire == NULL ||
+        n_values == 0 || n_values > SAMPLER_MAX_VALUES)
+    	return HAL_ERROR;
+
+    d = &devices[device_count];
+    memset(d, 0, sizeof(*d));
+    d->name = name;
+    d->acquire = acquire;
+    d->ctx = ctx;
+    d->n_values = n_values;
+    d->period_ticks = period_ticks;
+    d->trigger_tick = ticks;
+
+    *id = device_count++;
+    return HAL_OK;
+}
+
+void Sampler_TimerTick(void) {
+    uint32_t t = ++ticks;
+
+    for (uint8_t i = 0; i < device_count; i++) {
+        Sampler_Device_t *d = &devices[i];
+
+        if (t - d->trigger_tick < d->period_ticks)
+        	continue;
+
+        if (d->pending)
+        	d->overruns++;
+
+        d->trigger_tick = t;
+        d->pending = true;
+    }
+}
+
+uint8_t Sampler_Process(void) {
+    uint8_t taken = 0;
+
+    for (uint8_t i = 0; i < device_count; i++) {
+        Sampler_Device_t *d = &devices[i];
+        float values[SAMPLER_MAX_VALUES];
+        HAL_StatusTypeDef status;
+        uint32_t trigger;
+
+        if (!d->pending)
+        	continue;
+
+        // Take the trigger atomically against the timer ISR
+        __disable_irq();
+        trigger = d->trigger_tick;
+        d->pending = false;
+        __enable_irq();
+
+        status = d->acquire(d->ctx, values);
+
+        // No new data since the last sample: nothing to record, the next trigger polls again
+        if (status == HAL_BUSY)
+        	continue;
+
+        if (status != HAL_OK) {
+            d->errors++;
+            continue;
+        }
+
+        // Stamp at bus completion, not at trigger
+        Sampler_Record(d, trigger, Sampler_NowUs(), values);
+        taken++;
+    }
+
+    return taken;
+}
+
+uint64_t Sampler_NowUs(void) {
+    uint32_t t, c;
+    bool pending;
+
+    // Re-read when the tick interrupt lands between the two reads
+    do {
+        t = ticks;
+        c = Sampler_TimerCounterUs(&pending);
+    } while (t != ticks);
+
+    // Counter already wrapped but the update interrupt has not run yet: ticks is one behind
+    if (pending)
+    	t++;
+
+    return (uint64_t)t * tick_period_us + c;
+}
+
+uint32_t Sampler_GetTicks(void) {
+    return ticks;
+}
+
+HAL_StatusTypeDef Sampler_Align(uint8_t id, uint64_t t_us, float *values) {
+    Sampler_Device_t *d;
+
+    if (id >= device_count)
+    	return HAL_ERROR;
+
+    d = &devices[id];
+
+    // Walk from the newest sample back to the first one not after t_us
+    for (uint8_t age = 0; age < d->count; age++) {
+        const Sampler_Sample_t *s0 = Sampler_HistoryAt(d, age);
+
+        if (s0->timestamp_us > t_us)
+        	continue;
+
+        if (s0->timestamp_us == t_us) {
+            memcpy(values, s0->value, d->n_values * sizeof(float));
+            return HAL_OK;
+        }
+
+        // t_us is after the newest sample: no extrapolation
+        if (age == 0)
+        	return HAL_ERROR;
+
+        const Sampler_Sample_t *s1 = Sampler_HistoryAt(d, age - 1);
+        float w = (float)(t_us - s0->timestamp_us) / (float)(s1->timestamp_us - s0->timestamp_us);
+
+        for (uint8_t v = 0; v < d->n_values; v++)
+            values[v] = s0->value[v] + w * (s1->value[v] - s0->value[v]);
+
+        return HAL_OK;
+    }
+
+    return HAL_ERROR;
+}
+
+HAL_StatusTypeDef Sampler_GetLatest(uint8_t id, Sampler_Sample_t *sample) {
+    if (id >= device_count || devices[id].count == 0)
+    	return HAL_ERROR;
+
+    *sample = devices[id].history[devices[id].head];
+    return HAL_OK;
+}
+
+void Sampler_GetJitter(uint8_t id, Sampler_Jitter_t *jitter) {
+    memset(jitter, 0, sizeof(*jitter));
+    if (id >= device_count)
+    	return;
+
+    Sampler_Device_t *d = &devices[id];
+
+    jitter->samples = d->n_latency;
+    jitter->overruns = d->overruns;
+    jitter->errors = d->errors;
+    jitter->latency_min_us = d->latency_min;
+    jitter->latency_max_us = d->latency_max;
+    jitter->interval_max_us = d->interval_dev_max;
+
+    if (d->n_latency > 0)
+    	jitter->latency_mean_us = (float)d->latency_sum / (float)d->n_latency;
+
+    if (d->n_interval > 0)
+    	jitter->interval_rms_us = sqrtf((float)d->interval_dev2_sum / (float)d->n_interval);
+}
+
+HAL_StatusTypeDef Sampler_AcquireBH1750(void *ctx, float *values) {
+    HAL_StatusTypeDef status;
+    uint16_t raw;
+    uint8_t mode = (ctx != NULL) ? *(const uint8_t *)ctx : BH1750_CONT_H_RES_MODE;
+    uint32_t conversion_us = (mode == BH1750_CONT_L_RES_MODE) ? 16000u : 120000u;
+    uint64_t now = Sampler_NowUs();
+
+    // Sooner than one conversion after the last read the register still holds the same result
+    if (bh1750_read_once && now - bh1750_last_us < conversion_us)
+    	return HAL_BUSY;
+
+    // Continuous mode: the latest conversion is read without waiting
+    status = BH1750_ReadRaw(&raw);
+    if (status != HAL_OK)
+    	return status;
+
+    bh1750_last_us = now;
+    bh1750_read_once = true;
+
+    values[0] = BH1750_CalcLux(raw);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef Sampler_AcquireSPS30(void *ctx, float *values) {
+    HAL_StatusTypeDef status;
+    SPS30_Measurement_Float_t m;
+    uint8_t ready;
+    (void)ctx;
+
+    // The sensor updates at 1 Hz on its own clock: read each measurement exactly once
+    status = SPS30_ReadDataReady(&ready);
+    if (status != HAL_OK)
+    	return status;
+
+    if (!ready)
+    	return HAL_BUSY;
+
+    status = SPS30_ReadMeasuredValues(true, &m, NULL);
+    if (status != HAL_OK)
+    	return status;
+
+    memcpy(values, &m, sizeof(m));
+    return HAL_OK;
+}
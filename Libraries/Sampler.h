@@ -0,0 +1,179 @@
+/*
+ * Sampler.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#ifndef INC_SAMPLER_H_
+#define INC_SAMPLER_H_
+
+#include "main.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "BH1750.h"
+#include "SPS30.h"
+
+/* Sampling clock: a periodic hardware timer calls Sampler_TimerTick from its
+   update interrupt. The ISR only marks devices whose period elapsed; the bus
+   work happens in Sampler_Process from the main loop. Each sample is stamped
+   when its bus transaction completes, in microseconds, from the tick count
+   plus the timer counter (Sampler_TimerCounterUs). Samples of different
+   devices can then be interpolated onto the common tick timeline.
+
+   Drivers are sampled without blocking delays: the BH1750 must be left in a
+   continuous mode and the SPS30 must be measuring. An acquisition function
+   returns HAL_BUSY when the device has no new data since its last sample;
+   nothing is recorded and it is not counted as an error. The SPS30 produces
+   one measurement per second on its own clock, so poll it at a shorter
+   period (e.g. 100 ms) and each measurement is taken once, stamped within
+   one poll period of its arrival. */
+
+#ifndef SAMPLER_MAX_DEVICES
+#define SAMPLER_MAX_DEVICES     4
+#endif
+
+#ifndef SAMPLER_HISTORY_LEN
+#define SAMPLER_HISTORY_LEN     8       // Samples kept per device for interpolation
+#endif
+
+#define SAMPLER_MAX_VALUES      10      // SPS30 float measurement
+
+
+// HAL_OK with values filled, HAL_BUSY when there is no new data, anything else is an error
+typedef HAL_StatusTypeDef (*Sampler_AcquireFn)(void *ctx, float *values);
+
+typedef struct {
+    uint64_t timestamp_us;  // Bus transaction completion
+    float value[SAMPLER_MAX_VALUES];
+} Sampler_Sample_t;
+
+typedef struct {
+    uint32_t samples;
+    uint32_t overruns;      // Triggers that arrived while the previous one was still pending
+    uint32_t errors;        // Failed acquisitions (HAL_BUSY excluded)
+    float latency_mean_us;  // Trigger to completion
+    uint32_t latency_min_us;
+    uint32_t latency_max_us;
+    float interval_rms_us;  // RMS deviation of the sample interval from the nominal period
+    uint32_t interval_max_us;   // Largest absolute deviation
+} Sampler_Jitter_t;
+
+typedef struct {
+    const char *name;
+    Sampler_AcquireFn acquire;
+    void *ctx;
+    uint8_t n_values;
+    uint32_t period_ticks;
+
+    volatile uint32_t trigger_tick; // Tick of the pending trigger
+    volatile bool pending;
+    uint32_t last_tick;
+
+    Sampler_Sample_t history[SAMPLER_HISTORY_LEN];
+    uint8_t head;           // Index of the newest sample
+    uint8_t count;
+
+    // Jitter accumulators
+    uint32_t overruns;
+    uint32_t errors;
+    uint32_t n_latency;
+    uint64_t latency_sum;
+    uint32_t latency_min;
+    uint32_t latency_max;
+    uint32_t n_interval;
+    uint64_t interval_dev2_sum;
+    uint32_t interval_dev_max;
+} Sampler_Device_t;
+
+
+/**
+ * @brief Reset the sampler
+ * @param tick_us Period of the timer update interrupt in microseconds
+ */
+void Sampler_Init(uint32_t tick_us);
+
+
+/**
+ * @brief Register a device sampled every period_ticks timer ticks
+ * @param id Output, device index for the other calls
+ * @return HAL_ERROR when the table is full or the arguments are invalid
+ */
+HAL_StatusTypeDef Sampler_Register(const char *name, uint32_t period_ticks, Sampler_AcquireFn acquire,
+                                   void *ctx, uint8_t n_values, uint8_t *id);
+
+
+/**
+ * @brief Call from the timer update interrupt (HAL_TIM_PeriodElapsedCallback)
+ */
+void Sampler_TimerTick(void);
+
+
+/**
+ * @brief Run every pending acquisition; call from the main loop
+ * @return Number of samples taken (acquisitions without new data are not counted)
+ */
+uint8_t Sampler_Process(void);
+
+
+/**
+ * @brief Current time on the sampling timeline in microseconds
+ */
+uint64_t Sampler_NowUs(void);
+
+
+uint32_t Sampler_GetTicks(void);
+
+
+/**
+ * @brief Microseconds elapsed since the last tick, read from the timer counter.
+ *        An override reads __HAL_TIM_GET_COUNTER of the sampling timer scaled to
+ *        microseconds, then the update flag (__HAL_TIM_GET_FLAG(htim, TIM_FLAG_UPDATE)).
+ *        When the flag is set the counter has wrapped but Sampler_TimerTick has
+ *        not run yet: re-read the counter and report update_pending = true.
+ *
+ *        The default returns 0 with no pending update, i.e. timestamps only
+ *        have tick resolution. With a 1 ms tick that is not sub-millisecond:
+ *        override this hook when samples must be placed within the tick.
+ * @param update_pending Output, update interrupt pending for the wrap already counted
+ */
+uint32_t Sampler_TimerCounterUs(bool *update_pending);
+
+
+/**
+ * @brief Value of a device at time t_us, linearly interpolated between the two
+ *        samples around it
+ * @param values Output, n_values floats
+ * @return HAL_ERROR when t_us is outside the kept history
+ */
+HAL_StatusTypeDef Sampler_Align(uint8_t id, uint64_t t_us, float *values);
+
+
+HAL_StatusTypeDef Sampler_GetLatest(uint8_t id, Sampler_Sample_t *sample);
+
+
+void Sampler_GetJitter(uint8_t id, Sampler_Jitter_t *jitter);
+
+
+// Acquisition functions for the drivers in this repository
+
+/**
+ * @brief Reads the latest continuous-mode conversion. Returns HAL_BUSY when called
+ *        sooner than one conversion time (120 ms H-res, 16 ms L-res) after the
+ *        previous read, so a period shorter than that does not record duplicates.
+ * @param ctx NULL for BH1750_CONT_H_RES_MODE / _MODE2, or a const uint8_t * holding
+ *        the continuous mode the sensor was set to
+ */
+HAL_StatusTypeDef Sampler_AcquireBH1750(void *ctx, float *values);
+
+
+/**
+ * @brief Polls the data-ready flag and reads the float measurement only when set
+ * @return HAL_BUSY when no new measurement is available
+ */
+HAL_StatusTypeDef Sampler_AcquireSPS30(void *ctx, float *values);
+
+
+#endif /* INC_SAMPLER_H_ */
@@ -0,0 +1,418 @@
+/*
+ * SensorStore.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#include "SensorStore.h"
+
+
+static const uint32_t SensorStore_TierWidth[SENSORSTORE_NUM_TIERS] = {
+    SENSORSTORE_MINUTE_S,
+    SENSORSTORE_HOUR_S,
+    SENSORSTORE_DAY_S
+};
+
+
+static uint32_t SensorStore_Capacity(const SensorStore_TierState_t *t) {
+    return (uint32_t)t->per_page * t->cfg.page_count;
+}
+
+// Flash address of a logical record index
+static uint32_t SensorStore_RecordAddr(const SensorStore_t *store, const SensorStore_TierState_t *t, uint32_t index) {
+    uint32_t slot = index % SensorStore_Capacity(t);
+    uint32_t page = slot / t->per_page;
+
+    return t->cfg.base_addr + page * store->flash.page_size
+           + sizeof(SensorStore_PageHeader_t) + (slot % t->per_page) * sizeof(SensorStore_Rollup_t);
+}
+
+static HAL_StatusTypeDef SensorStore_ReadStart(SensorStore_t *store, SensorStore_TierState_t *t, uint32_t index, uint32_t *start) {
+    return store->flash.read(store->flash.ctx, SensorStore_RecordAddr(store, t, index), start, sizeof(uint32_t));
+}
+
+static void SensorStore_ResetBucket(SensorStore_Rollup_t *bucket, uint32_t start) {
+    memset(bucket, 0, sizeof(*bucket));
+    bucket->start = start;
+}
+
+static void SensorStore_MergeAgg(SensorStore_Agg_t *dst, const SensorStore_Agg_t *src) {
+    if (src->count == 0)
+    	return;
+
+    if (dst->count == 0) {
+        *dst = *src;
+        return;
+    }
+
+    dst->count += src->count;
+    dst->sum   += src->sum;
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+static void SensorStore_MergeBucket(SensorStore_Rollup_t *dst, const SensorStore_Rollup_t *src) {
+    for (int i = 0; i < SENSORSTORE_NUM_CHANNELS; i++)
+        SensorStore_MergeAgg(&dst->ch[i], &src->ch[i]);
+}
+
+static HAL_StatusTypeDef SensorStore_FormatTier(SensorStore_t *store, SensorStore_TierState_t *t) {
+    HAL_StatusTypeDef status;
+
+    for (uint16_t p = 0; p < t->cfg.page_count; p++) {
+        status = store->flash.erase_page(store->flash.ctx, t->cfg.base_addr + p * store->flash.page_size);
+        if (status != HAL_OK)
+        	return status;
+    }
+
+    t->first = 0;
+    t->next = 0;
+    return HAL_OK;
+}
+
+// Rebuild first/next from the page headers left in flash
+static HAL_StatusTypeDef SensorStore_MountTier(SensorStore_t *store, SensorStore_TierState_t *t) {
+    HAL_StatusTypeDef status;
+    SensorStore_PageHeader_t hdr;
+    bool found = false;
+    uint32_t oldest = 0, newest = 0;
+
+    for (uint16_t p = 0; p < t->cfg.page_count; p++) {
+        status = store->flash.read(store->flash.ctx, t->cfg.base_addr + p * store->flash.page_size, &hdr, sizeof(hdr));
+        if (status != HAL_OK)
+        	return status;
+
+        if (hdr.magic != SENSORSTORE_PAGE_MAGIC)
+        	continue;
+
+        // A header must describe the page it lives on, otherwise the tier is foreign
+        if ((hdr.first_index % t->per_page) != 0 ||
+            (hdr.first_index % SensorStore_Capacity(t)) / t->per_page != p)
+        	return SensorStore_FormatTier(store, t);
+
+        if (!found || hdr.first_index < oldest) oldest = hdr.first_index;
+        if (!found || hdr.first_index > newest) newest = hdr.first_index;
+        found = true;
+    }
+
+    if (!found)
+    	return SensorStore_FormatTier(store, t);
+
+    if (newest - oldest >= SensorStore_Capacity(t))
+    	return SensorStore_FormatTier(store, t);
+
+    // Count the programmed records on the newest page
+    uint16_t used = 0;
+    while (used < t->per_page) {
+        uint32_t start;
+        status = SensorStore_ReadStart(store, t, newest + used, &start);
+        if (status != HAL_OK)
+        	return status;
+        if (start == SENSORSTORE_ERASED_WORD)
+        	break;
+        used++;
+    }
+
+    t->first = oldest;
+    t->next = newest + used;
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef SensorStore_Append(SensorStore_t *store, SensorStore_TierState_t *t, const SensorStore_Rollup_t *rec) {
+    HAL_StatusTypeDef status;
+    uint32_t capacity = SensorStore_Capacity(t);
+    uint32_t slot = t->next % capacity;
+
+    // First record of a page: recycle the oldest page and stamp a new header
+    if ((slot % t->per_page) == 0) {
+        uint32_t page_addr = t->cfg.base_addr + (slot / t->per_page) * store->flash.page_size;
+        SensorStore_PageHeader_t hdr = { SENSORSTORE_PAGE_MAGIC, t->next };
+        uint32_t magic = SENSORSTORE_ERASED_WORD;
+
+        // Pages still blank from the format are not erased a second time on the first pass
+        if (t->next < capacity) {
+            status = store->flash.read(store->flash.ctx, page_addr, &magic, sizeof(magic));
+            if (status != HAL_OK)
+            	return status;
+        }
+
+        if (t->next >= capacity || magic != SENSORSTORE_ERASED_WORD) {
+            status = store->flash.erase_page(store->flash.ctx, page_addr);
+            if (status != HAL_OK)
+            	return status;
+        }
+
+        if (t->next >= capacity)
+        	t->first = t->next - capacity + t->per_page;
+
+        status = store->flash.program(store->flash.ctx, page_addr, &hdr, sizeof(hdr));
+        if (status != HAL_OK)
+        	return status;
+    }
+
+    status = store->flash.program(store->flash.ctx, SensorStore_RecordAddr(store, t, t->next), rec, sizeof(*rec));
+    if (status != HAL_OK)
+    	return status;
+
+    t->next++;
+    return HAL_OK;
+}
+
+// Move the open bucket of a tier forward to the bucket holding timestamp, cascading finished buckets upwards
+static HAL_StatusTypeDef SensorStore_Roll(SensorStore_t *store, uint8_t tier, uint32_t timestamp) {
+    HAL_StatusTypeDef status;
+    SensorStore_TierState_t *t = &store->tier[tier];
+    uint32_t start = timestamp - (timestamp % SensorStore_TierWidth[tier]);
+
+    // Same bucket; SensorStore_Push already rejected samples for older minutes
+    if (t->open_valid && start <= t->open.start)
+    	return HAL_OK;
+
+    if (t->open_valid) {
+        status = SensorStore_Append(store, t, &t->open);
+        if (status != HAL_OK)
+        	return status;
+
+        if (tier + 1 < SENSORSTORE_NUM_TIERS) {
+            status = SensorStore_Roll(store, tier + 1, t->open.start);
+            if (status != HAL_OK)
+            	return status;
+            SensorStore_MergeBucket(&store->tier[tier + 1].open, &t->open);
+        }
+    }
+
+    SensorStore_ResetBucket(&t->open, start);
+    t->open_valid = true;
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef SensorStore_Push(SensorStore_t *store, const SensorStore_Raw_t *sample) {
+    HAL_StatusTypeDef status;
+    uint32_t start = sample->timestamp - (sample->timestamp % SENSORSTORE_MINUTE_S);
+
+    // Buckets are written in start order; a sample for an older minute would land in the wrong one
+    if (start < store->newest_start) {
+        store->late++;
+        return HAL_ERROR;
+    }
+
+    if (store->raw_count == SENSORSTORE_RAW_RING_LEN) {
+        status = SensorStore_Compact(store);
+        if (status != HAL_OK)
+        	return status;
+    }
+
+    uint16_t idx = (store->raw_head + store->raw_count) % SENSORSTORE_RAW_RING_LEN;
+    store->raw[idx] = *sample;
+    store->raw_count++;
+    store->newest_start = start;
+
+    return HAL_OK;
+}
+
+
+HAL_StatusTypeDef SensorStore_Init(SensorStore_t *store, const SensorStore_Flash_t *flash,
+                                   const SensorStore_TierConfig_t tiers[SENSORSTORE_NUM_TIERS], bool format) {
+    HAL_StatusTypeDef status;
+
+    if (flash->page_size < sizeof(SensorStore_PageHeader_t) + sizeof(SensorStore_Rollup_t))
+    	return HAL_ERROR;
+
+    memset(store, 0, sizeof(*store));
+    store->flash = *flash;
+
+    for (int i = 0; i < SENSORSTORE_NUM_TIERS; i++) {
+        SensorStore_TierState_t *t = &store->tier[i];
+
+        if (tiers[i].page_count < 2 || (tiers[i].base_addr % flash->page_size) != 0)
+        	return HAL_ERROR;
+
+        t->cfg = tiers[i];
+        t->per_page = (flash->page_size - sizeof(SensorStore_PageHeader_t)) / sizeof(SensorStore_Rollup_t);
+
+        status = format ? SensorStore_FormatTier(store, t) : SensorStore_MountTier(store, t);
+        if (status != HAL_OK)
+        	return status;
+    }
+
+    // Samples older than the newest minute already in flash are late
+    SensorStore_TierState_t *minute = &store->tier[SENSORSTORE_TIER_MINUTE];
+    if (minute->next > minute->first)
+    	return SensorStore_ReadStart(store, minute, minute->next - 1, &store->newest_start);
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef SensorStore_AddSPS30(SensorStore_t *store, uint32_t timestamp, const SPS30_Measurement_Float_t *data) {
+    SensorStore_Raw_t sample;
+
+    sample.timestamp = timestamp;
+    sample.mask = (1u << SENSORSTORE_SPS30_CHANNELS) - 1u;
+    memcpy(sample.value, data, SENSORSTORE_SPS30_CHANNELS * sizeof(float));
+    sample.value[SENSORSTORE_CH_LUX] = 0.0f;
+
+    return SensorStore_Push(store, &sample);
+}
+
+HAL_StatusTypeDef SensorStore_AddLux(SensorStore_t *store, uint32_t timestamp, float lux) {
+    SensorStore_Raw_t sample;
+
+    memset(&sample, 0, sizeof(sample));
+    sample.timestamp = timestamp;
+    sample.mask = 1u << SENSORSTORE_CH_LUX;
+    sample.value[SENSORSTORE_CH_LUX] = lux;
+
+    return SensorStore_Push(store, &sample);
+}
+
+HAL_StatusTypeDef SensorStore_Compact(SensorStore_t *store) {
+    HAL_StatusTypeDef status;
+    SensorStore_TierState_t *minute = &store->tier[SENSORSTORE_TIER_MINUTE];
+
+    while (store->raw_count > 0) {
+        const SensorStore_Raw_t *sample = &store->raw[store->raw_head];
+
+        status = SensorStore_Roll(store, SENSORSTORE_TIER_MINUTE, sample->timestamp);
+        if (status != HAL_OK)
+        	return status;
+
+        for (int i = 0; i < SENSORSTORE_NUM_CHANNELS; i++) {
+            if (!(sample->mask & (1u << i)))
+            	continue;
+
+            SensorStore_Agg_t one = { 1, sample->value[i], sample->value[i], sample->value[i] };
+            SensorStore_MergeAgg(&minute->open.ch[i], &one);
+        }
+
+        store->raw_head = (store->raw_head + 1) % SENSORSTORE_RAW_RING_LEN;
+        store->raw_count--;
+    }
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef SensorStore_Flush(SensorStore_t *store) {
+    HAL_StatusTypeDef status;
+
+    status = SensorStore_Compact(store);
+    if (status != HAL_OK)
+    	return status;
+
+    // Partial buckets share their start with the rest of the bucket written later; Query merges them
+    for (uint8_t i = 0; i < SENSORSTORE_NUM_TIERS; i++) {
+        SensorStore_TierState_t *t = &store->tier[i];
+
+        if (!t->open_valid)
+        	continue;
+
+        status = SensorStore_Append(store, t, &t->open);
+        if (status != HAL_OK)
+        	return status;
+
+        if (i + 1 < SENSORSTORE_NUM_TIERS) {
+            status = SensorStore_Roll(store, i + 1, t->open.start);
+            if (status != HAL_OK)
+            	return status;
+            SensorStore_MergeBucket(&store->tier[i + 1].open, &t->open);
+        }
+
+        t->open_valid = false;
+    }
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef SensorStore_Query(SensorStore_t *store, SensorStore_Tier_t tier, uint32_t from, uint32_t to,
+                                    SensorStore_Rollup_t *out, uint32_t max_out, uint32_t *n_out) {
+    HAL_StatusTypeDef status;
+    uint32_t n = 0;
+
+    *n_out = 0;
+    if (tier >= SENSORSTORE_NUM_TIERS || from > to)
+    	return HAL_ERROR;
+
+    SensorStore_TierState_t *t = &store->tier[tier];
+    uint32_t width = SensorStore_TierWidth[tier];
+
+    status = SensorStore_Compact(store);
+    if (status != HAL_OK)
+    	return status;
+
+    // Buckets overlapping 'from' start after from - width
+    uint32_t key = (from >= width - 1) ? from - (width - 1) : 0;
+
+    // Lower bound on the bucket start over [first, next)
+    uint32_t lo = t->first, hi = t->next;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        uint32_t start;
+
+        status = SensorStore_ReadStart(store, t, mid, &start);
+        if (status != HAL_OK)
+        	return status;
+
+        if (start < key)
+        	lo = mid + 1;
+        else
+        	hi = mid;
+    }
+
+    // Sequential read of the k matching records
+    for (uint32_t i = lo; i < t->next; i++) {
+        SensorStore_Rollup_t rec;
+
+        status = store->flash.read(store->flash.ctx, SensorStore_RecordAddr(store, t, i), &rec, sizeof(rec));
+        if (status != HAL_OK)
+        	return status;
+
+        if (rec.start > to)
+        	break;
+
+        if (n > 0 && out[n - 1].start == rec.start) {
+            SensorStore_MergeBucket(&out[n - 1], &rec);
+            continue;
+        }
+
+        if (n == max_out) {
+            *n_out = n;
+            return HAL_BUSY;
+        }
+        out[n++] = rec;
+    }
+
+    // Buckets still open in RAM; higher tiers hold the older data so walk downwards
+    for (int j = tier; j >= 0; j--) {
+        SensorStore_TierState_t *src = &store->tier[j];
+
+        if (!src->open_valid)
+        	continue;
+
+        uint32_t start = src->open.start - (src->open.start % width);
+        if (start + width <= from || start > to)
+        	continue;
+
+        if (n > 0 && out[n - 1].start == start) {
+            SensorStore_MergeBucket(&out[n - 1], &src->open);
+            continue;
+        }
+
+        if (n == max_out) {
+            *n_out = n;
+            return HAL_BUSY;
+        }
+        SensorStore_ResetBucket(&out[n], start);
+        SensorStore_MergeBucket(&out[n], &src->open);
+        n++;
+    }
+
+    *n_out = n;
+    return HAL_OK;
+}
+
+float SensorStore_Mean(const SensorStore_Rollup_t *bucket, SensorStore_Channel_t ch) {
+    if (bucket->ch[ch].count == 0)
+    	return 0.0f;
+
+    return bucket->ch[ch].sum / (float)bucket->ch[ch].count;
+}
@@ -0,0 +1,187 @@
+/*
+ * SensorStore.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#ifndef INC_SENSORSTORE_H_
+#define INC_SENSORSTORE_H_
+
+#include "main.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "SPS30.h"
+
+/* Raw samples are buffered in RAM and compacted into three rollup tiers
+   (minute / hour / day). Each tier is a circular set of fixed-size flash
+   pages holding time-ordered records, so a range query is a binary search
+   for the first bucket followed by a sequential read of k buckets. */
+
+#ifndef SENSORSTORE_RAW_RING_LEN
+#define SENSORSTORE_RAW_RING_LEN    32      // Raw samples buffered before compaction
+#endif
+
+#define SENSORSTORE_PAGE_MAGIC      0x52535453u  // "STSR"
+#define SENSORSTORE_ERASED_WORD     0xFFFFFFFFu
+
+#define SENSORSTORE_MINUTE_S        60u
+#define SENSORSTORE_HOUR_S          3600u
+#define SENSORSTORE_DAY_S           86400u
+
+
+// Channel indices: 0..9 follow the field order of SPS30_Measurement_Float_t
+typedef enum
+{
+  SENSORSTORE_CH_PM1_0 = 0,
+  SENSORSTORE_CH_PM2_5,
+  SENSORSTORE_CH_PM4_0,
+  SENSORSTORE_CH_PM10,
+  SENSORSTORE_CH_NC0_5,
+  SENSORSTORE_CH_NC1_0,
+  SENSORSTORE_CH_NC2_5,
+  SENSORSTORE_CH_NC4_0,
+  SENSORSTORE_CH_NC10,
+  SENSORSTORE_CH_TYPICAL_SIZE,
+  SENSORSTORE_CH_LUX,
+
+  SENSORSTORE_NUM_CHANNELS
+} SensorStore_Channel_t;
+
+#define SENSORSTORE_SPS30_CHANNELS  10
+
+typedef enum
+{
+  SENSORSTORE_TIER_MINUTE = 0,
+  SENSORSTORE_TIER_HOUR,
+  SENSORSTORE_TIER_DAY,
+
+  SENSORSTORE_NUM_TIERS
+} SensorStore_Tier_t;
+
+// Flash backend: addresses are absolute, erase works on whole pages
+typedef struct {
+    HAL_StatusTypeDef (*read)(void *ctx, uint32_t addr, void *buf, uint32_t len);
+    HAL_StatusTypeDef (*program)(void *ctx, uint32_t addr, const void *buf, uint32_t len);
+    HAL_StatusTypeDef (*erase_page)(void *ctx, uint32_t addr);
+    void *ctx;
+    uint32_t page_size;
+} SensorStore_Flash_t;
+
+// Aggregate of one channel over one bucket
+typedef struct {
+    uint32_t count;
+    float sum;
+    float min;
+    float max;
+} SensorStore_Agg_t;
+
+// One rollup record as stored in flash
+typedef struct {
+    uint32_t start;     // Bucket start time in seconds (aligned to the tier width)
+    SensorStore_Agg_t ch[SENSORSTORE_NUM_CHANNELS];
+} SensorStore_Rollup_t;
+
+// Page header written at the start of every tier page
+typedef struct {
+    uint32_t magic;
+    uint32_t first_index;   // Logical index of the first record on this page
+} SensorStore_PageHeader_t;
+
+// Flash placement of one tier
+typedef struct {
+    uint32_t base_addr;     // Must be page aligned
+    uint16_t page_count;    // At least 2, one page is always sacrificed on wrap
+} SensorStore_TierConfig_t;
+
+// Runtime state of one tier
+typedef struct {
+    SensorStore_TierConfig_t cfg;
+    uint16_t per_page;      // Records per page
+    uint32_t first;         // Oldest logical record index still in flash
+    uint32_t next;          // Logical index of the next record to write
+    SensorStore_Rollup_t open;  // Bucket currently being accumulated in RAM
+    bool open_valid;
+} SensorStore_TierState_t;
+
+// One raw sample in the RAM ring
+typedef struct {
+    uint32_t timestamp;
+    uint16_t mask;          // Bit n set when channel n is present
+    float value[SENSORSTORE_NUM_CHANNELS];
+} SensorStore_Raw_t;
+
+typedef struct {
+    SensorStore_Flash_t flash;
+    SensorStore_TierState_t tier[SENSORSTORE_NUM_TIERS];
+    SensorStore_Raw_t raw[SENSORSTORE_RAW_RING_LEN];
+    uint16_t raw_head;
+    uint16_t raw_count;
+    uint32_t newest_start;  // Minute start of the newest accepted sample, kept across Flush
+    uint32_t late;          // Samples rejected for an older minute than newest_start
+} SensorStore_t;
+
+
+/**
+ * @brief Attach the store to flash and recover tier state from existing pages
+ * @param store Store instance
+ * @param flash Flash backend
+ * @param tiers Placement of the minute, hour and day tiers
+ * @param format true to erase all tier pages instead of recovering them
+ * @return HAL_OK on success
+ */
+HAL_StatusTypeDef SensorStore_Init(SensorStore_t *store, const SensorStore_Flash_t *flash,
+                                   const SensorStore_TierConfig_t tiers[SENSORSTORE_NUM_TIERS], bool format);
+
+
+/**
+ * @brief Add a sample. Samples may arrive out of order within the minute of the
+ *        newest sample; an older minute is already closed and the sample is rejected.
+ * @return HAL_ERROR for a late sample (counted in store->late)
+ */
+HAL_StatusTypeDef SensorStore_AddSPS30(SensorStore_t *store, uint32_t timestamp, const SPS30_Measurement_Float_t *data);
+
+
+HAL_StatusTypeDef SensorStore_AddLux(SensorStore_t *store, uint32_t timestamp, float lux);
+
+
+/**
+ * @brief Drain the raw ring into the open rollup buckets, writing finished buckets to flash
+ * @param store Store instance
+ * @return HAL_OK on success
+ */
+HAL_StatusTypeDef SensorStore_Compact(SensorStore_t *store);
+
+
+/**
+ * @brief Write every open bucket to flash (e.g. before power down).
+ *        Each call appends a partial record to all three tiers, so it uses up
+ *        tier capacity like a finished bucket does: flushing often pushes old
+ *        days out of a small day tier. Flush on power-down, not periodically.
+ * @param store Store instance
+ * @return HAL_OK on success
+ */
+HAL_StatusTypeDef SensorStore_Flush(SensorStore_t *store);
+
+
+/**
+ * @brief Read all buckets of a tier that overlap [from, to], oldest first
+ * @param store Store instance
+ * @param tier Tier to query
+ * @param from Range start in seconds (inclusive)
+ * @param to Range end in seconds (inclusive)
+ * @param out Output buckets
+ * @param max_out Capacity of out
+ * @param n_out Number of buckets written to out
+ * @return HAL_OK on success, HAL_BUSY when out was too small (n_out == max_out)
+ */
+HAL_StatusTypeDef SensorStore_Query(SensorStore_t *store, SensorStore_Tier_t tier, uint32_t from, uint32_t to,
+                                    SensorStore_Rollup_t *out, uint32_t max_out, uint32_t *n_out);
+
+
+float SensorStore_Mean(const SensorStore_Rollup_t *bucket, SensorStore_Channel_t ch);
+
+
+#endif /* INC_SENSORSTORE_H_ */
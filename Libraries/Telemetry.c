@@ -0,0 +1,253 @@
+/*
+ * Telemetry.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#include "Telemetry.h"
+
+
+static uint8_t Telemetry_VarintLen(uint32_t v) {
+    uint8_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+static uint8_t *Telemetry_PutVarint(uint8_t *p, uint32_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+// Signed delta to varint-friendly unsigned: 0, -1, 1, -2, 2 ... -> 0, 1, 2, 3, 4 ...
+static uint32_t Telemetry_ZigZag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (v < 0 ? 0xFFFFFFFFu : 0u);
+}
+
+static int32_t Telemetry_UnZigZag(uint32_t u) {
+    return (int32_t)((u >> 1) ^ (0u - (u & 1u)));
+}
+
+// Field i as a float in the channel's unit (raw BH1750 counts are taken to lux)
+static float Telemetry_FieldValue(uint8_t type, const uint8_t *fields, uint8_t size, uint8_t i) {
+    float v;
+
+    if (size == sizeof(float)) {
+        memcpy(&v, &fields[i * size], sizeof(float));
+    } else {
+        uint16_t u;
+        memcpy(&u, &fields[i * size], sizeof(uint16_t));
+        v = (type == TELEMETRY_REC_LUX_RAW) ? (float)u / 1.2f : (float)u;
+    }
+
+    return v;
+}
+
+static bool Telemetry_Changed(const Telemetry_Encoder_t *enc, uint8_t ch, float value) {
+    if (enc->deadband == NULL || !(enc->sent_mask & (1u << ch)))
+    	return true;
+
+    float diff = value - enc->last_sent[ch];
+    if (diff < 0.0f)
+    	diff = -diff;
+
+    return diff > enc->deadband[ch];
+}
+
+/* Shared path for all record types: fields are 'size' bytes apart in the
+   driver struct, starting at channel 'first_ch'. The bitmap is computed
+   before anything is written so a full frame is left untouched. */
+static HAL_StatusTypeDef Telemetry_Add(Telemetry_Encoder_t *enc, uint8_t type, uint32_t ts_ms,
+                                       const uint8_t *fields, uint8_t size, uint8_t first_ch, uint8_t n_ch) {
+    uint16_t bitmap = 0;
+    uint8_t n_set = 0;
+    uint8_t n_suppressed = 0;
+
+    if (enc->count == 0) {
+        enc->base_ts = ts_ms;
+        enc->last_ts = ts_ms;
+    }
+
+    for (uint8_t i = 0; i < n_ch; i++) {
+        if (Telemetry_Changed(enc, first_ch + i, Telemetry_FieldValue(type, fields, size, i))) {
+            bitmap |= 1u << i;
+            n_set++;
+        } else {
+            n_suppressed++;
+        }
+    }
+
+    if (n_set == 0) {
+        enc->suppressed += n_suppressed;
+        return HAL_OK;
+    }
+
+    // Samples from different drivers may arrive out of order: the delta is signed
+    int64_t delta = (int64_t)ts_ms - (int64_t)enc->last_ts;
+    if (delta > INT32_MAX || delta < INT32_MIN)
+    	return HAL_BUSY;
+
+    uint32_t dt = Telemetry_ZigZag((int32_t)delta);
+    uint16_t need = 1 + Telemetry_VarintLen(dt) + (n_ch > 1 ? 2 : 0) + n_set * size;
+
+    // A record that does not fit an empty frame never will
+    if (enc->len + need > enc->mtu && enc->count == 0)
+    	return HAL_ERROR;
+
+    if (enc->count == TELEMETRY_MAX_RECORDS || enc->len + need > enc->mtu)
+    	return HAL_BUSY;
+
+    // Counted only once the record is committed, a HAL_BUSY retry starts over
+    enc->suppressed += n_suppressed;
+
+    uint8_t *p = &enc->buf[enc->len];
+    *p++ = type;
+    p = Telemetry_PutVarint(p, dt);
+    if (n_ch > 1) {
+        *p++ = bitmap & 0xFF;
+        *p++ = (bitmap >> 8) & 0xFF;
+    }
+
+    for (uint8_t i = 0; i < n_ch; i++) {
+        if (!(bitmap & (1u << i)))
+        	continue;
+
+        memcpy(p, &fields[i * size], size);
+        p += size;
+
+        // Deadband reference is the last value sent, not the last value seen
+        if (enc->deadband != NULL) {
+            enc->last_sent[first_ch + i] = Telemetry_FieldValue(type, fields, size, i);
+            enc->sent_mask |= 1u << (first_ch + i);
+        }
+    }
+
+    enc->len += need;
+    enc->count++;
+    enc->last_ts = ts_ms;
+    return HAL_OK;
+}
+
+
+HAL_StatusTypeDef Telemetry_Init(Telemetry_Encoder_t *enc, uint8_t *buf, uint16_t mtu, const float *deadband) {
+    if (mtu < TELEMETRY_MIN_MTU)
+    	return HAL_ERROR;
+
+    memset(enc, 0, sizeof(*enc));
+    enc->buf = buf;
+    enc->mtu = mtu;
+    enc->deadband = deadband;
+    Telemetry_Reset(enc);
+    return HAL_OK;
+}
+
+void Telemetry_Reset(Telemetry_Encoder_t *enc) {
+    enc->len = TELEMETRY_HEADER_LEN;
+    enc->count = 0;
+    enc->sent_mask = 0;
+}
+
+HAL_StatusTypeDef Telemetry_AddSPS30(Telemetry_Encoder_t *enc, uint32_t ts_ms, const SPS30_Measurement_Float_t *data) {
+    return Telemetry_Add(enc, TELEMETRY_REC_SPS30_FLOAT, ts_ms, (const uint8_t *)data, sizeof(float), 0, TELEMETRY_PM_CHANNELS);
+}
+
+HAL_StatusTypeDef Telemetry_AddSPS30U16(Telemetry_Encoder_t *enc, uint32_t ts_ms, const SPS30_Measurement_U16_t *data) {
+    return Telemetry_Add(enc, TELEMETRY_REC_SPS30_U16, ts_ms, (const uint8_t *)data, sizeof(uint16_t), 0, TELEMETRY_PM_CHANNELS);
+}
+
+HAL_StatusTypeDef Telemetry_AddLux(Telemetry_Encoder_t *enc, uint32_t ts_ms, float lux) {
+    return Telemetry_Add(enc, TELEMETRY_REC_LUX, ts_ms, (const uint8_t *)&lux, sizeof(float), TELEMETRY_CH_LUX, 1);
+}
+
+HAL_StatusTypeDef Telemetry_AddLuxRaw(Telemetry_Encoder_t *enc, uint32_t ts_ms, uint16_t raw) {
+    return Telemetry_Add(enc, TELEMETRY_REC_LUX_RAW, ts_ms, (const uint8_t *)&raw, sizeof(uint16_t), TELEMETRY_CH_LUX, 1);
+}
+
+uint16_t Telemetry_Finish(Telemetry_Encoder_t *enc) {
+    if (enc->count == 0)
+    	return 0;
+
+    enc->buf[0] = TELEMETRY_VERSION;
+    enc->buf[1] = enc->count;
+    enc->buf[2] = enc->base_ts & 0xFF;
+    enc->buf[3] = (enc->base_ts >> 8) & 0xFF;
+    enc->buf[4] = (enc->base_ts >> 16) & 0xFF;
+    enc->buf[5] = (enc->base_ts >> 24) & 0xFF;
+
+    return enc->len;
+}
+
+HAL_StatusTypeDef Telemetry_DecodeNext(const uint8_t *frame, uint16_t len, uint16_t *offset,
+                                       uint32_t *ts, Telemetry_Record_t *rec) {
+    uint16_t pos = *offset;
+
+    if (pos == 0) {
+        if (len < TELEMETRY_HEADER_LEN || frame[0] != TELEMETRY_VERSION)
+        	return HAL_ERROR;
+
+        *ts = (uint32_t)frame[2] | ((uint32_t)frame[3] << 8) |
+              ((uint32_t)frame[4] << 16) | ((uint32_t)frame[5] << 24);
+        pos = TELEMETRY_HEADER_LEN;
+    }
+
+    if (pos >= len)
+    	return HAL_BUSY;
+
+    uint8_t type = frame[pos++];
+    uint8_t size, first_ch, n_ch;
+
+    switch (type)
+    {
+        case TELEMETRY_REC_SPS30_FLOAT: size = 4; first_ch = 0; n_ch = TELEMETRY_PM_CHANNELS; break;
+        case TELEMETRY_REC_SPS30_U16:   size = 2; first_ch = 0; n_ch = TELEMETRY_PM_CHANNELS; break;
+        case TELEMETRY_REC_LUX:         size = 4; first_ch = TELEMETRY_CH_LUX; n_ch = 1; break;
+        case TELEMETRY_REC_LUX_RAW:     size = 2; first_ch = TELEMETRY_CH_LUX; n_ch = 1; break;
+        default:
+            return HAL_ERROR;
+    }
+
+    // Signed time delta
+    uint32_t dt = 0;
+    for (uint8_t shift = 0; ; shift += 7) {
+        if (pos >= len || shift > 28)
+        	return HAL_ERROR;
+        uint8_t b = frame[pos++];
+        dt |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80))
+        	break;
+    }
+    *ts += (uint32_t)Telemetry_UnZigZag(dt);
+
+    uint16_t bitmap = 1;
+    if (n_ch > 1) {
+        if (pos + 2 > len)
+        	return HAL_ERROR;
+        bitmap = frame[pos] | ((uint16_t)frame[pos + 1] << 8);
+        pos += 2;
+    }
+
+    rec->type = type;
+    rec->timestamp = *ts;
+    rec->bitmap = bitmap;
+
+    for (uint8_t i = 0; i < n_ch; i++) {
+        if (!(bitmap & (1u << i)))
+        	continue;
+
+        if (pos + size > len)
+        	return HAL_ERROR;
+
+        rec->value[first_ch + i] = Telemetry_FieldValue(type, &frame[pos], size, 0);
+        pos += size;
+    }
+
+    *offset = pos;
+    return HAL_OK;
+}
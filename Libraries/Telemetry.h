@@ -0,0 +1,131 @@
+/*
+ * Telemetry.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: 2023
+ */
+
+#ifndef INC_TELEMETRY_H_
+#define INC_TELEMETRY_H_
+
+#include "main.h"
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "SPS30.h"
+
+/* Binary uplink frame, filled up to a configurable MTU.
+
+   Frame:   [version:1][count:1][base_ts_ms:4]  record * count
+   Record:  [type:1][dt_ms:zigzag varint][bitmap:2, 10-channel types only][fields]
+
+   dt_ms is the signed time since the previous record (since base_ts for the
+   first), zigzag encoded, so records need not be in time order: SPS30 and
+   lux samples can be packed straight from each driver's sample buffer.
+   Fields are copied straight from the driver structs in MCU byte order
+   (little-endian), only the channels whose bit is set in the bitmap.
+   With a deadband configured, a channel is only sent when it moved more than
+   the deadband away from the last value sent in the same frame. Deadbands
+   are in the unit of the channel as the driver reports it (ug/m3, #/cm3, um
+   for the SPS30), and in lux for the lux channel whether it is added as lux
+   or as raw BH1750 counts. The first sample of each frame always carries
+   every channel, so frames decode on their own. */
+
+#define TELEMETRY_VERSION           0x02    // 0x01: unsigned dt_ms
+#define TELEMETRY_HEADER_LEN        6
+#define TELEMETRY_MAX_RECORDS       255
+#define TELEMETRY_PM_CHANNELS       10
+#define TELEMETRY_NUM_CHANNELS      11      // 10 SPS30 channels + lux
+#define TELEMETRY_CH_LUX            10
+#define TELEMETRY_MIN_MTU           (TELEMETRY_HEADER_LEN + 1 + 1 + 2 + 10 * 4)   // One full SPS30 float record
+
+// Record types
+#define TELEMETRY_REC_SPS30_FLOAT   0x01    // SPS30_Measurement_Float_t, 4 bytes per field
+#define TELEMETRY_REC_SPS30_U16     0x02    // SPS30_Measurement_U16_t, 2 bytes per field
+#define TELEMETRY_REC_LUX           0x03    // float lux
+#define TELEMETRY_REC_LUX_RAW       0x04    // uint16 BH1750 count, lux = raw / 1.2
+
+
+typedef struct {
+    uint8_t *buf;
+    uint16_t mtu;
+    uint16_t len;
+    uint8_t count;
+    uint32_t base_ts;
+    uint32_t last_ts;
+
+    // Deadband per channel, 0 sends every change; NULL disables suppression
+    const float *deadband;
+    float last_sent[TELEMETRY_NUM_CHANNELS];
+    uint16_t sent_mask;     // Channels with a valid last_sent in this frame
+
+    uint32_t suppressed;    // Fields dropped by the deadband since init
+} Telemetry_Encoder_t;
+
+// One decoded record, absent channels are left untouched
+typedef struct {
+    uint8_t type;
+    uint32_t timestamp;
+    uint16_t bitmap;
+    float value[TELEMETRY_NUM_CHANNELS];
+} Telemetry_Record_t;
+
+
+/**
+ * @brief Attach an output buffer and start the first frame
+ * @param enc Encoder instance
+ * @param buf Frame buffer, at least mtu bytes
+ * @param mtu Maximum frame length in bytes
+ * @param deadband TELEMETRY_NUM_CHANNELS thresholds, or NULL
+ * @return HAL_ERROR when mtu is below TELEMETRY_MIN_MTU
+ */
+HAL_StatusTypeDef Telemetry_Init(Telemetry_Encoder_t *enc, uint8_t *buf, uint16_t mtu, const float *deadband);
+
+
+/**
+ * @brief Start a new frame in the same buffer (after the previous one was sent)
+ */
+void Telemetry_Reset(Telemetry_Encoder_t *enc);
+
+
+/**
+ * @brief Append a sample to the current frame
+ * @return HAL_OK when added or fully suppressed, HAL_BUSY when the frame is full or
+ *         ts_ms is over 2^31 ms from the previous record (send it, call
+ *         Telemetry_Reset and add the sample again), HAL_ERROR when
+ *         the record does not fit even an empty frame
+ */
+HAL_StatusTypeDef Telemetry_AddSPS30(Telemetry_Encoder_t *enc, uint32_t ts_ms, const SPS30_Measurement_Float_t *data);
+
+
+HAL_StatusTypeDef Telemetry_AddSPS30U16(Telemetry_Encoder_t *enc, uint32_t ts_ms, const SPS30_Measurement_U16_t *data);
+
+
+HAL_StatusTypeDef Telemetry_AddLux(Telemetry_Encoder_t *enc, uint32_t ts_ms, float lux);
+
+
+HAL_StatusTypeDef Telemetry_AddLuxRaw(Telemetry_Encoder_t *enc, uint32_t ts_ms, uint16_t raw);
+
+
+/**
+ * @brief Close the current frame
+ * @return Frame length in bytes, 0 when the frame holds no records
+ */
+uint16_t Telemetry_Finish(Telemetry_Encoder_t *enc);
+
+
+/**
+ * @brief Decode a frame record by record
+ * @param frame Frame bytes
+ * @param len Frame length
+ * @param offset In: 0 for the first call, then the value left by the previous call
+ * @param ts Running timestamp, set by the first call
+ * @param rec Decoded record, values of absent channels are kept from the previous call
+ * @return HAL_OK when a record was decoded, HAL_BUSY at the end of the frame, HAL_ERROR when malformed
+ */
+HAL_StatusTypeDef Telemetry_DecodeNext(const uint8_t *frame, uint16_t len, uint16_t *offset,
+                                       uint32_t *ts, Telemetry_Record_t *rec);
+
+
+#endif /* INC_TELEMETRY_H_ */